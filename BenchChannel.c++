@@ -0,0 +1,209 @@
+// -------------------------------
+// projects/deque/BenchChannel.c++
+// Copyright (C) 2013
+// Glenn P. Downing
+// -------------------------------
+
+/*
+To run the benchmarks:
+% g++ -pedantic -std=c++20 -Wall -O2 -DNDEBUG -pthread BenchChannel.c++ -o BenchChannel
+% BenchChannel > BenchChannel.out
+*/
+
+// --------
+// includes
+// --------
+
+#include <atomic> // atomic
+#include <chrono> // steady_clock
+#include <condition_variable> // condition_variable
+#include <iomanip> // setw
+#include <iostream> // cout, endl
+#include <mutex> // mutex, unique_lock
+#include <optional> // optional
+#include <thread> // thread, yield
+
+#include "Channel.h"
+#include "Deque.h"
+
+// -------
+// elapsed
+// -------
+
+/**
+ * @param b a time_point
+ * @return the nanoseconds since b
+ */
+double elapsed (std::chrono::steady_clock::time_point b) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - b).count();}
+
+// ----------
+// coroutines
+// ----------
+
+MyTask ping (MyChannel<int>& out, MyChannel<int>& in, int m, std::atomic<bool>& done) {
+    for (int i = 0; i != m; ++i) {
+        co_await out.push(i);
+        co_await in.pop();}
+    out.close();
+    done = true;}
+
+MyTask pong (MyChannel<int>& in, MyChannel<int>& out) {
+    while (std::optional<int> v = co_await in.pop())
+        co_await out.push(*v);}
+
+MyTask produce (MyChannel<int>& c, int m) {
+    for (int i = 0; i != m; ++i)
+        co_await c.push(i);
+    c.close();}
+
+MyTask consume (MyChannel<int>& c, std::atomic<bool>& done) {
+    long s = 0;
+    while (std::optional<int> v = co_await c.pop())
+        s += *v;
+    done = s != 0;}
+
+// ------------
+// MyBlockQueue
+// ------------
+
+/**
+ * The thread baseline: a MyDeque behind a mutex and a condition variable.
+ */
+class MyBlockQueue {
+    private:
+        std::mutex              _m;
+        std::condition_variable _cv;
+        MyDeque<int>            _q;
+
+    public:
+        void push (int v) {
+            {
+            std::lock_guard<std::mutex> l(_m);
+            _q.push_back(v);}
+            _cv.notify_one();}
+
+        int pop () {
+            std::unique_lock<std::mutex> l(_m);
+            while (_q.empty())
+                _cv.wait(l);
+            const int v = _q.front();
+            _q.pop_front();
+            return v;}};
+
+// ---
+// run
+// ---
+
+/**
+ * Runs an inline executor dry, or waits for a thread pool to set done
+ */
+void run (MyInlineExecutor& e, std::atomic<bool>&) {
+    e.run();}
+
+void run (MyThreadPool&, std::atomic<bool>& done) {
+    while (!done)
+        std::this_thread::yield();}
+
+// --------------
+// bench_pingpong
+// --------------
+
+/**
+ * @param e an executor
+ * @param m an int, the number of round trips
+ * @return the nanoseconds per round trip
+ */
+template <typename E>
+double bench_pingpong (E& e, int m) {
+    MyChannel<int> a(e, 0);
+    MyChannel<int> b(e, 0);
+    std::atomic<bool> done(false);
+    const std::chrono::steady_clock::time_point t = std::chrono::steady_clock::now();
+    spawn(e, pong(a, b));
+    spawn(e, ping(a, b, m, done));
+    run(e, done);
+    return elapsed(t) / m;}
+
+/**
+ * @param m an int, the number of round trips
+ * @return the nanoseconds per round trip between two threads
+ */
+double bench_pingpong (int m) {
+    MyBlockQueue a;
+    MyBlockQueue b;
+    const std::chrono::steady_clock::time_point t = std::chrono::steady_clock::now();
+    std::thread p([&] () {
+        for (int i = 0; i != m; ++i)
+            b.push(a.pop());});
+    for (int i = 0; i != m; ++i) {
+        a.push(i);
+        b.pop();}
+    p.join();
+    return elapsed(t) / m;}
+
+// ----------------
+// bench_throughput
+// ----------------
+
+/**
+ * @param e an executor
+ * @param m an int, the number of values
+ * @param capacity a size_t
+ * @return the nanoseconds per value through a channel of the given capacity
+ */
+template <typename E>
+double bench_throughput (E& e, int m, std::size_t capacity) {
+    MyChannel<int> c(e, capacity);
+    std::atomic<bool> done(false);
+    const std::chrono::steady_clock::time_point t = std::chrono::steady_clock::now();
+    spawn(e, consume(c, done));
+    spawn(e, produce(c, m));
+    run(e, done);
+    return elapsed(t) / m;}
+
+/**
+ * @param m an int, the number of values
+ * @return the nanoseconds per value from one thread to another
+ */
+double bench_throughput (int m) {
+    MyBlockQueue c;
+    long s = 0;
+    const std::chrono::steady_clock::time_point t = std::chrono::steady_clock::now();
+    std::thread p([&] () {
+        for (int i = 0; i != m; ++i)
+            c.push(i);});
+    for (int i = 0; i != m; ++i)
+        s += c.pop();
+    p.join();
+    const double r = elapsed(t) / m;
+    return s ? r : 0;}
+
+// ----
+// main
+// ----
+
+int main () {
+    using namespace std;
+    ios_base::sync_with_stdio(false); // turn off synchronization with C I/O
+    cout << "BenchChannel.c++" << endl << endl;
+
+    const int m = 1000000;
+
+    cout << "ping-pong (ns per round trip)" << endl;
+    cout << setw(14) << "inline" << setw(14) << "pool(2)" << setw(14) << "threads" << endl;
+    {
+    MyInlineExecutor e;
+    MyThreadPool     p(2);
+    cout << setw(14) << bench_pingpong(e, m) << setw(14) << bench_pingpong(p, m / 10) << setw(14) << bench_pingpong(m / 10) << endl;}
+    cout << endl;
+
+    cout << "producer to consumer (ns per value)" << endl;
+    cout << setw(10) << "capacity" << setw(14) << "inline" << setw(14) << "pool(2)" << setw(14) << "threads" << endl;
+    for (size_t c = 1; c <= 1024; c *= 32) {
+        MyInlineExecutor e;
+        MyThreadPool     p(2);
+        cout << setw(10) << c << setw(14) << bench_throughput(e, m, c) << setw(14) << bench_throughput(p, m, c) << setw(14) << bench_throughput(m) << endl;}
+
+    cout << endl << "Done." << endl;
+    return 0;}
@@ -0,0 +1,485 @@
+// -----------------------------
+// projects/deque/BenchDeque.c++
+// Copyright (C) 2013
+// Glenn P. Downing
+// -----------------------------
+
+/*
+To run the benchmarks:
+% g++ -pedantic -std=c++0x -Wall -O2 -DNDEBUG BenchDeque.c++ -o BenchDeque
+% BenchDeque > BenchDeque.out
+*/
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // max, min, sort, stable_sort
+#include <chrono> // steady_clock
+#include <cstdio> // fread, fwrite, tmpfile
+#include <cstdlib> // rand, srand
+#include <functional> // plus
+#include <iomanip> // setw
+#include <iostream> // cout, endl
+#include <thread> // hardware_concurrency
+#include <utility> // make_pair, pair
+#include <vector> // vector
+
+#include "CompressedDeque.h"
+#include "Deque.h"
+#include "DequeStream.h"
+#include "HugePageAllocator.h"
+#include "IndexedDeque.h"
+#include "SlidingWindow.h"
+#include "SoADeque.h"
+
+// -------
+// elapsed
+// -------
+
+/**
+ * @param b a time_point
+ * @return the nanoseconds since b
+ */
+double elapsed (std::chrono::steady_clock::time_point b) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - b).count();}
+
+// ------------
+// bench_middle
+// ------------
+
+/**
+ * @param n a size_t, the size of the deque
+ * @param m a size_t, the number of insert/erase pairs
+ * @return the nanoseconds per insert/erase pair at random positions
+ */
+template <typename C>
+double bench_middle (std::size_t n, std::size_t m) {
+    C x(n, 1);
+    std::srand(1);
+    const std::chrono::steady_clock::time_point b = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i != m; ++i) {
+        x.insert(x.begin() + std::rand() % (x.size() + 1), 2);
+        x.erase(x.begin() + std::rand() % x.size());}
+    return elapsed(b) / m;}
+
+// ----------
+// bench_ends
+// ----------
+
+/**
+ * @param n a size_t
+ * @return the nanoseconds per push_back, push_front, pop_front, pop_back
+ */
+template <typename C>
+double bench_ends (std::size_t n) {
+    C x;
+    const std::chrono::steady_clock::time_point b = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i != n; ++i) {
+        x.push_back(1);
+        x.push_front(2);}
+    for (std::size_t i = 0; i != n; ++i) {
+        x.pop_front();
+        x.pop_back();}
+    return elapsed(b) / (4 * n);}
+
+// ----------
+// bench_scan
+// ----------
+
+volatile int sink; // keeps the scans from being optimized away
+
+/**
+ * @param n a size_t
+ * @return the nanoseconds per element of an iterator scan
+ */
+template <typename C>
+double bench_scan (std::size_t n) {
+    const C x(n, 1);
+    int s = 0;
+    const std::chrono::steady_clock::time_point b = std::chrono::steady_clock::now();
+    for (typename C::const_iterator p = x.begin(); p != x.end(); ++p)
+        s += *p;
+    const double t = elapsed(b) / n;
+    sink = s;
+    return t;}
+
+// -----------
+// bench_write
+// -----------
+
+/**
+ * @param n a size_t
+ * @param naive a bool, true to write element by element through stdio
+ * @return the MB per second of writing and then reading back n ints
+ */
+std::pair<double, double> bench_write (std::size_t n, bool naive) {
+    MyDeque<int> x;
+    for (std::size_t i = 0; i != n; ++i)
+        x.push_back(i);
+    std::FILE* f = std::tmpfile();
+    const int fd = fileno(f);
+    std::chrono::steady_clock::time_point b = std::chrono::steady_clock::now();
+    if (naive) {
+        const std::size_t s = x.size();
+        std::fwrite(&s, sizeof(s), 1, f);
+        for (std::size_t i = 0; i != s; ++i)
+            std::fwrite(&x[i], sizeof(int), 1, f);
+        std::fflush(f);}
+    else
+        write_to(fd, x);
+    const double w = elapsed(b);
+    std::rewind(f);
+    MyDeque<int> y;
+    b = std::chrono::steady_clock::now();
+    if (naive) {
+        std::size_t s;
+        if (std::fread(&s, sizeof(s), 1, f) == 1)
+            for (std::size_t i = 0; i != s; ++i) {
+                int v;
+                if (std::fread(&v, sizeof(v), 1, f) != 1)
+                    break;
+                y.push_back(v);}}
+    else
+        read_from(fd, y);
+    const double r = elapsed(b);
+    std::fclose(f);
+    assert(x == y);
+    const double mb = n * sizeof(int) / 1e6;
+    return std::make_pair(mb / (w / 1e9), mb / (r / 1e9));}
+
+// -----------
+// bench_pages
+// -----------
+
+/**
+ * @param x a const deque reference
+ * @param m a size_t, the number of random reads
+ * @return the nanoseconds per element of a scan and per random read
+ */
+template <typename C>
+std::pair<double, double> bench_pages (const C& x, std::size_t m) {
+    long s = 0;
+    std::chrono::steady_clock::time_point b = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i != x.size(); ++i)
+        s += x[i];
+    const double scan = elapsed(b) / x.size();
+    unsigned long r = 1;
+    b = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i != m; ++i) {
+        r = r * 6364136223846793005UL + 1442695040888963407UL;
+        s += x[(r >> 17) % x.size()];}
+    const double random = elapsed(b) / m;
+    sink = s;
+    return std::make_pair(scan, random);}
+
+// ------------
+// bench_window
+// ------------
+
+/**
+ * @param w a long, the window size in ticks
+ * @param m a long, the number of ticks timed
+ * @param naive a bool, true to rescan a MyDeque window every tick
+ * @return the nanoseconds per tick to update the window and read its min, max, and sum
+ */
+double bench_window (long w, long m, bool naive) {
+    MyDeque<int> x;
+    MyMonotonicWindow<int> lo;
+    MyMonotonicWindow<int, std::greater<int> > hi;
+    MyWindowAggregate<long, std::plus<long> > sum;
+    unsigned long r = 1;
+    long s = 0;
+    std::chrono::steady_clock::time_point b;
+    for (long i = 0; i != w + m; ++i) {
+        if (i == w)
+            b = std::chrono::steady_clock::now();
+        r = r * 6364136223846793005UL + 1442695040888963407UL;
+        const int v = static_cast<int>(r >> 40);
+        if (naive) {
+            x.push_back(v);
+            if (static_cast<long>(x.size()) > w)
+                x.pop_front();
+            if (i >= w) {
+                int a = x[0];
+                int z = x[0];
+                long t = 0;
+                for (std::size_t j = 0; j != x.size(); ++j) {
+                    a = std::min(a, x[j]);
+                    z = std::max(z, x[j]);
+                    t += x[j];}
+                s += a + z + t;}}
+        else {
+            lo.push(i, v);
+            hi.push(i, v);
+            sum.push(i, v);
+            lo.evict(i - w + 1);
+            hi.evict(i - w + 1);
+            sum.evict(i - w + 1);
+            if (i >= w)
+                s += lo.top() + hi.top() + sum.get();}}
+    const double e = elapsed(b) / m;
+    sink = s;
+    return e;}
+
+// ---------
+// bench_soa
+// ---------
+
+/**
+ * A quote with several fields, of which a scan reads one.
+ */
+struct Quote {
+    double price;
+    double volume;
+    long   time;
+    int    id;};
+
+/**
+ * @param n a size_t, the number of quotes
+ * @param m a size_t, the number of scans
+ * @return the nanoseconds per element to sum the prices of a MyDeque<Quote>,
+ * of a MySoADeque by index, and of its price column
+ */
+std::pair<double, std::pair<double, double> > bench_soa (std::size_t n, std::size_t m) {
+    MyDeque<Quote> x;
+    MySoADeque<double, double, long, int> y;
+    for (std::size_t i = 0; i != n; ++i) {
+        const Quote q = {i * 0.5, 1.0, static_cast<long>(i), static_cast<int>(i)};
+        x.push_back(q);
+        y.push_back(std::make_tuple(q.price, q.volume, q.time, q.id));}
+    double s = 0;
+    std::chrono::steady_clock::time_point b = std::chrono::steady_clock::now();
+    for (std::size_t j = 0; j != m; ++j)
+        for (std::size_t i = 0; i != n; ++i)
+            s += x[i].price;
+    const double a = elapsed(b) / (n * m);
+    b = std::chrono::steady_clock::now();
+    for (std::size_t j = 0; j != m; ++j)
+        for (std::size_t i = 0; i != n; ++i)
+            s += y.get<0>(i);
+    const double c = elapsed(b) / (n * m);
+    b = std::chrono::steady_clock::now();
+    for (std::size_t j = 0; j != m; ++j) {
+        const MyColumn<double> p = y.column<0>();
+        for (const double* i = p.begin(); i != p.end(); ++i)
+            s += *i;}
+    const double d = elapsed(b) / (n * m);
+    sink = static_cast<int>(s);
+    return std::make_pair(a, std::make_pair(c, d));}
+
+// ----------------
+// bench_compressed
+// ----------------
+
+/**
+ * @param x a deque reference
+ * @param n a size_t, the number of timestamps
+ * @param m a size_t, the number of random reads
+ * @return the nanoseconds per push, per element scanned, and per random read,
+ * through a const reference
+ */
+template <typename C>
+std::pair<double, std::pair<double, double> > bench_compressed (C& x, std::size_t n, std::size_t m) {
+    unsigned long r = 1;
+    long long t = 1380000000000LL;
+    std::chrono::steady_clock::time_point b = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i != n; ++i) {
+        r = r * 6364136223846793005UL + 1442695040888963407UL;
+        x.push_back(t += (r >> 59));}
+    const double push = elapsed(b) / n;
+    const C& y = x;
+    long long s = 0;
+    b = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i != n; ++i)
+        s += y[i];
+    const double scan = elapsed(b) / n;
+    b = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i != m; ++i) {
+        r = r * 6364136223846793005UL + 1442695040888963407UL;
+        s += y[(r >> 17) % n];}
+    const double random = elapsed(b) / m;
+    sink = static_cast<int>(s);
+    return std::make_pair(push, std::make_pair(scan, random));}
+
+// ----------
+// bench_sort
+// ----------
+
+/**
+ * @param n a size_t, the number of elements
+ * @param which an int: 0 std::sort of a vector copy, 1 MyDeque::sort,
+ * 2 MyDeque::sort on every hardware thread, 3 std::stable_sort of a vector copy,
+ * 4 MyDeque::stable_sort with a comparator
+ * @return the nanoseconds per element to sort n random longs, copying included
+ */
+double bench_sort (std::size_t n, int which) {
+    MyDeque<long> x;
+    unsigned long r = 1;
+    for (std::size_t i = 0; i != n; ++i) {
+        r = r * 6364136223846793005UL + 1442695040888963407UL;
+        x.push_back(static_cast<long>(r >> 1));}
+    const unsigned threads = std::max(1U, std::thread::hardware_concurrency());
+    const std::chrono::steady_clock::time_point b = std::chrono::steady_clock::now();
+    if ((which == 0) || (which == 3)) {
+        std::vector<long> v(x.begin(), x.end());
+        if (which == 0)
+            std::sort(v.begin(), v.end());
+        else
+            std::stable_sort(v.begin(), v.end());
+        std::copy(v.begin(), v.end(), x.begin());}
+    else if (which == 1)
+        x.sort();
+    else if (which == 2)
+        x.sort(std::less<long>(), threads);
+    else
+        x.stable_sort(std::greater<long>());
+    const double e = elapsed(b) / n;
+    sink = static_cast<int>(x[n / 2]);
+    return e;}
+
+// ----
+// main
+// ----
+
+// ----------
+// bench_bulk
+// ----------
+
+/**
+ * @param n a size_t, the number of elements
+ * @param which an int: 0 push_back, 1 the fill constructor, 2 the range
+ * constructor from a vector, 3 assign of n copies on every hardware thread,
+ * 4 assign of a range on every hardware thread
+ * @return the nanoseconds per element to load n ints into a new MyDeque
+ */
+double bench_bulk (std::size_t n, int which) {
+    const std::vector<int> v(n, 1);
+    const unsigned threads = std::max(1U, std::thread::hardware_concurrency());
+    const std::chrono::steady_clock::time_point b = std::chrono::steady_clock::now();
+    {
+    MyDeque<int> x;
+    if (which == 0)
+        for (std::size_t i = 0; i != n; ++i)
+            x.push_back(1);
+    else if (which == 1) {
+        MyDeque<int> y(n, 1);
+        x.swap(y);}
+    else if (which == 2) {
+        MyDeque<int> y(v.begin(), v.end());
+        x.swap(y);}
+    else if (which == 3)
+        x.assign(n, 1, threads);
+    else
+        x.assign(v.begin(), v.end(), threads);
+    sink = x[n / 2];
+    }
+    return elapsed(b) / n;}
+
+int main () {
+    using namespace std;
+    ios_base::sync_with_stdio(false); // turn off synchronization with C I/O
+    cout << "BenchDeque.c++" << endl << endl;
+
+    cout << "middle insert + erase (ns per pair)" << endl;
+    cout << setw(10) << "n" << setw(14) << "MyDeque" << setw(16) << "MyIndexedDeque" << endl;
+    for (size_t n = 1000; n <= 1024000; n *= 4)
+        cout << setw(10) << n
+             << setw(14) << bench_middle< MyDeque<int> >(n, 2000)
+             << setw(16) << bench_middle< MyIndexedDeque<int> >(n, 2000) << endl;
+    cout << endl;
+
+    cout << "end operations (ns per op)" << endl;
+    cout << setw(10) << "n" << setw(14) << "MyDeque" << setw(16) << "MyIndexedDeque" << endl;
+    for (size_t n = 1000; n <= 1000000; n *= 10)
+        cout << setw(10) << n
+             << setw(14) << bench_ends< MyDeque<int> >(n)
+             << setw(16) << bench_ends< MyIndexedDeque<int> >(n) << endl;
+    cout << endl;
+
+    cout << "scan (ns per element)" << endl;
+    cout << setw(10) << "n" << setw(14) << "MyDeque" << setw(16) << "MyIndexedDeque" << endl;
+    for (size_t n = 1000; n <= 1000000; n *= 10)
+        cout << setw(10) << n
+             << setw(14) << bench_scan< MyDeque<int> >(n)
+             << setw(16) << bench_scan< MyIndexedDeque<int> >(n) << endl;
+
+    cout << endl;
+
+    cout << "serialization (MB/s write, read)" << endl;
+    cout << setw(10) << "n" << setw(14) << "naive write" << setw(14) << "naive read" << setw(14) << "write_to" << setw(14) << "read_from" << endl;
+    for (size_t n = 1000000; n <= 10000000; n *= 10) {
+        const pair<double, double> a = bench_write(n, true);
+        const pair<double, double> b = bench_write(n, false);
+        cout << setw(10) << n << setw(14) << a.first << setw(14) << a.second << setw(14) << b.first << setw(14) << b.second << endl;}
+
+    cout << endl;
+
+    cout << "huge pages (ns per element scanned, ns per random read)" << endl;
+    cout << setw(10) << "n" << setw(14) << "4K scan" << setw(14) << "4K random" << setw(14) << "huge scan" << setw(14) << "huge random" << endl;
+    for (size_t n = 1 << 20; n <= (1 << 26); n <<= 3) {
+        pair<double, double> a;
+        pair<double, double> b;
+        {
+        const MyDeque<long> x(n, 1);
+        a = bench_pages(x, 10000000);}
+        {
+        const MyDeque<long, MyHugePageAllocator<long> > x(n, 1);
+        b = bench_pages(x, 10000000);}
+        cout << setw(10) << n << setw(14) << a.first << setw(14) << a.second << setw(14) << b.first << setw(14) << b.second << endl;}
+
+    cout << endl;
+
+    cout << "sliding window min, max, and sum (ns per tick)" << endl;
+    cout << setw(10) << "w" << setw(14) << "rescan" << setw(14) << "incremental" << endl;
+    for (long w = 1000; w <= 1000000; w *= 10)
+        cout << setw(10) << w << setw(14) << bench_window(w, std::max(100L, 100000000L / w), true) << setw(14) << bench_window(w, 1000000, false) << endl;
+
+    cout << endl;
+
+    cout << "sum of one field of four (ns per element)" << endl;
+    cout << setw(10) << "n" << setw(14) << "MyDeque" << setw(14) << "SoA get" << setw(14) << "SoA column" << endl;
+    for (size_t n = 1000; n <= 10000000; n *= 100) {
+        const pair<double, pair<double, double> > r = bench_soa(n, 100000000 / n);
+        cout << setw(10) << n << setw(14) << r.first << setw(14) << r.second.first << setw(14) << r.second.second << endl;}
+
+    cout << endl;
+
+    cout << "compressed timestamps (ns per push, per element scanned, per random read)" << endl;
+    cout << setw(10) << "n" << setw(22) << "" << setw(10) << "push" << setw(10) << "scan" << setw(10) << "random" << setw(10) << "ratio" << endl;
+    for (size_t n = 1000000; n <= 100000000; n *= 10) {
+        pair<double, pair<double, double> > a;
+        pair<double, pair<double, double> > b;
+        MyCompressionReport r;
+        {
+        MyDeque<long long> x;
+        a = bench_compressed(x, n, 1000000);}
+        {
+        MyCompressedDeque<long long> x;
+        b = bench_compressed(x, n, 1000000);
+        r = x.report();}
+        cout << setw(10) << n << setw(22) << "MyDeque" << setw(10) << a.first << setw(10) << a.second.first << setw(10) << a.second.second << setw(10) << 1 << endl;
+        cout << setw(10) << "" << setw(22) << "MyCompressedDeque" << setw(10) << b.first << setw(10) << b.second.first << setw(10) << b.second.second << setw(10) << r.ratio() << endl;}
+
+    cout << endl;
+
+    cout << "sort random longs (ns per element)" << endl;
+    cout << setw(10) << "n" << setw(14) << "std::sort" << setw(14) << "sort" << setw(14) << "sort(all)" << setw(14) << "std::stable" << setw(14) << "stable(>)" << endl;
+    for (size_t n = 100000; n <= 100000000; n *= 10) {
+        cout << setw(10) << n;
+        for (int w = 0; w != 5; ++w)
+            cout << setw(14) << bench_sort(n, w);
+        cout << endl;}
+
+    cout << endl;
+
+    cout << "bulk load of ints, destruction included (ns per element)" << endl;
+    cout << setw(10) << "n" << setw(14) << "push_back" << setw(14) << "fill" << setw(14) << "range" << setw(14) << "fill(all)" << setw(14) << "range(all)" << endl;
+    for (size_t n = 100000; n <= 100000000; n *= 10) {
+        cout << setw(10) << n;
+        for (int w = 0; w != 5; ++w)
+            cout << setw(14) << bench_bulk(n, w);
+        cout << endl;}
+
+    cout << endl << "Done." << endl;
+    return 0;}
@@ -0,0 +1,422 @@
+// ------------------------
+// projects/deque/Channel.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// ------------------------
+
+#ifndef Channel_h
+#define Channel_h
+
+// --------
+// includes
+// --------
+
+#include <cassert> // assert
+#include <condition_variable> // condition_variable
+#include <coroutine> // coroutine_handle, noop_coroutine, suspend_always, suspend_never
+#include <cstddef> // size_t
+#include <exception> // terminate
+#include <mutex> // lock_guard, mutex, unique_lock
+#include <optional> // nullopt, optional
+#include <thread> // thread
+#include <utility> // move
+
+#include "Deque.h"
+
+// ----------
+// MyExecutor
+// ----------
+
+/**
+ * Something that resumes coroutines.
+ */
+class MyExecutor {
+    public:
+        virtual ~MyExecutor () {}
+
+        /**
+         * @param h a coroutine_handle to resume later, exactly once
+         */
+        virtual void schedule (std::coroutine_handle<> h) = 0;};
+
+// ----------------
+// MyInlineExecutor
+// ----------------
+
+/**
+ * A run loop for a single thread: run() resumes coroutines until none is ready.
+ * Not thread safe.
+ */
+class MyInlineExecutor : public MyExecutor {
+    private:
+        MyDeque< std::coroutine_handle<> > _ready;
+
+    public:
+        void schedule (std::coroutine_handle<> h) {
+            _ready.push_back(h);}
+
+        /**
+         * Resumes ready coroutines, including any they schedule, until none is left
+         */
+        void run () {
+            while (!_ready.empty()) {
+                std::coroutine_handle<> h = _ready.front();
+                _ready.pop_front();
+                h.resume();}}};
+
+// ------------
+// MyThreadPool
+// ------------
+
+/**
+ * A fixed number of threads resuming coroutines from one shared queue.
+ * The destructor waits for the queue to empty; coroutines still suspended
+ * on a channel then are never resumed.
+ */
+class MyThreadPool : public MyExecutor {
+    private:
+        std::mutex                         _m;
+        std::condition_variable            _cv;
+        MyDeque< std::coroutine_handle<> > _ready;
+        bool                               _stop;
+        MyDeque<std::thread*>              _threads;
+
+        void work () {
+            std::unique_lock<std::mutex> l(_m);
+            while (true) {
+                while (!_stop && _ready.empty())
+                    _cv.wait(l);
+                if (_ready.empty())
+                    return;
+                std::coroutine_handle<> h = _ready.front();
+                _ready.pop_front();
+                l.unlock();
+                h.resume();
+                l.lock();}}
+
+        /**
+         * Lets the threads drain the ready queue, then joins and deletes them
+         */
+        void stop () {
+            {
+            std::lock_guard<std::mutex> l(_m);
+            _stop = true;}
+            _cv.notify_all();
+            for (std::size_t i = 0; i != _threads.size(); ++i)
+                if (_threads[i]) {
+                    _threads[i]->join();
+                    delete _threads[i];}}
+
+        MyThreadPool (const MyThreadPool&);
+        MyThreadPool& operator = (const MyThreadPool&);
+
+    public:
+        /**
+         * @param n a size_t, the number of threads
+         * If a thread can't be started, stops the ones that were and rethrows
+         */
+        explicit MyThreadPool (std::size_t n)
+            : _stop(false) {
+            try {
+                for (std::size_t i = 0; i != n; ++i) {
+                    _threads.push_back(0);
+                    _threads.back() = new std::thread(&MyThreadPool::work, this);}}
+            catch (...) {
+                stop();
+                throw;}}
+
+        ~MyThreadPool () {
+            stop();}
+
+        void schedule (std::coroutine_handle<> h) {
+            {
+            std::lock_guard<std::mutex> l(_m);
+            _ready.push_back(h);}
+            _cv.notify_one();}};
+
+// ------
+// MyTask
+// ------
+
+/**
+ * A fire-and-forget coroutine. It starts suspended, runs once spawned,
+ * and frees itself when it finishes.
+ */
+struct MyTask {
+    struct promise_type {
+        MyTask get_return_object () {
+            return MyTask(std::coroutine_handle<promise_type>::from_promise(*this));}
+
+        std::suspend_always initial_suspend () noexcept {
+            return std::suspend_always();}
+
+        std::suspend_never final_suspend () noexcept {
+            return std::suspend_never();}
+
+        void return_void () {}
+
+        void unhandled_exception () {
+            std::terminate();}};
+
+    std::coroutine_handle<promise_type> _h;
+
+    explicit MyTask (std::coroutine_handle<promise_type> h)
+        : _h(h) {}};
+
+/**
+ * @param e an executor
+ * @param t a task
+ * Schedules t to start on e
+ */
+inline void spawn (MyExecutor& e, MyTask t) {
+    e.schedule(t._h);}
+
+// ---------
+// MyChannel
+// ---------
+
+/**
+ * A channel between coroutines whose buffer is a MyDeque<T>.
+ * co_await push(v) yields false if the channel is closed; otherwise it
+ * completes at once while the buffer has room, or waits for a receiver.
+ * co_await pop() yields nullopt once the channel is closed and drained.
+ * A push that finds a receiver waiting hands the value over and transfers
+ * control straight to the receiver; the sender is rescheduled on the executor.
+ * A capacity of 0 makes every push a rendezvous.
+ * Safe to use from any executor, including a thread pool.
+ */
+template <typename T>
+class MyChannel {
+    public:
+        static const std::size_t UNBOUNDED = ~std::size_t(0);
+
+    private:
+        // -------
+        // waiters
+        // -------
+
+        struct Receiver {
+            std::coroutine_handle<> _h;
+            std::optional<T>        _value;};
+
+        struct Sender {
+            std::coroutine_handle<> _h;
+            const T*                _value;
+            bool                    _ok;};
+
+    private:
+        // ----
+        // data
+        // ----
+
+        MyExecutor&           _e;
+        const std::size_t     _capacity;
+        std::mutex            _m;
+        MyDeque<T>            _buffer;
+        MyDeque<Receiver*>    _receivers;
+        MyDeque<Sender*>      _senders;
+        bool                  _closed;
+
+        MyChannel (const MyChannel&);
+        MyChannel& operator = (const MyChannel&);
+
+        // ----
+        // take
+        // ----
+
+        /**
+         * @return the next value, refilling the buffer from a waiting sender
+         * Requires _m held and a value in the buffer or a waiting sender
+         */
+        T take () {
+            if (_buffer.empty()) {
+                Sender* s = _senders.front();
+                _senders.pop_front();
+                const T v = *s->_value;
+                s->_ok = true;
+                _e.schedule(s->_h);
+                return v;}
+            const T v = _buffer.front();
+            _buffer.pop_front();
+            if (!_senders.empty()) {
+                Sender* s = _senders.front();
+                _senders.pop_front();
+                _buffer.push_back(*s->_value);
+                s->_ok = true;
+                _e.schedule(s->_h);}
+            return v;}
+
+        // -----------
+        // PushAwaiter
+        // -----------
+
+        class PushAwaiter {
+            private:
+                MyChannel&                   _c;
+                const T                      _v;
+                Sender                       _s;
+                std::unique_lock<std::mutex> _l;
+
+            public:
+                PushAwaiter (MyChannel& c, const T& v)
+                    : _c(c), _v(v), _l(c._m, std::defer_lock) {
+                    _s._value = &_v;
+                    _s._ok    = false;}
+
+                // Holds the lock from here through await_suspend when it returns false.
+                bool await_ready () {
+                    _l.lock();
+                    if (_c._closed)
+                        _s._ok = false;
+                    else if (!_c._receivers.empty())
+                        return false;
+                    else if (_c._buffer.size() < _c._capacity) {
+                        _c._buffer.push_back(_v);
+                        _s._ok = true;}
+                    else
+                        return false;
+                    _l.unlock();
+                    return true;}
+
+                // Once the lock is released another thread may resume h and
+                // destroy this awaiter, so the lock moves to a local first.
+                std::coroutine_handle<> await_suspend (std::coroutine_handle<> h) {
+                    std::unique_lock<std::mutex> l(std::move(_l));
+                    MyExecutor& e = _c._e;
+                    _s._h = h;
+                    if (_c._receivers.empty()) {
+                        _c._senders.push_back(&_s);
+                        return std::noop_coroutine();}
+                    Receiver* r = _c._receivers.front();
+                    _c._receivers.pop_front();
+                    r->_value = _v;
+                    _s._ok = true;
+                    const std::coroutine_handle<> next = r->_h;
+                    l.unlock();
+                    e.schedule(h);
+                    return next;}
+
+                bool await_resume () {
+                    return _s._ok;}};
+
+        // ----------
+        // PopAwaiter
+        // ----------
+
+        class PopAwaiter {
+            private:
+                MyChannel&                   _c;
+                Receiver                     _r;
+                std::unique_lock<std::mutex> _l;
+
+            public:
+                explicit PopAwaiter (MyChannel& c)
+                    : _c(c), _l(c._m, std::defer_lock) {}
+
+                // Holds the lock from here through await_suspend when it returns false.
+                bool await_ready () {
+                    _l.lock();
+                    if (!_c._buffer.empty() || !_c._senders.empty())
+                        _r._value = _c.take();
+                    else if (!_c._closed)
+                        return false;
+                    _l.unlock();
+                    return true;}
+
+                void await_suspend (std::coroutine_handle<> h) {
+                    std::unique_lock<std::mutex> l(std::move(_l));
+                    _r._h = h;
+                    _c._receivers.push_back(&_r);}
+
+                std::optional<T> await_resume () {
+                    return std::move(_r._value);}};
+
+        // ------------
+        // BatchAwaiter
+        // ------------
+
+        class BatchAwaiter {
+            private:
+                PopAwaiter  _p;
+                MyChannel&  _c;
+                MyDeque<T>& _out;
+                std::size_t _max;
+
+            public:
+                BatchAwaiter (MyChannel& c, MyDeque<T>& out, std::size_t max)
+                    : _p(c), _c(c), _out(out), _max(max) {
+                    assert(max != 0);}
+
+                bool await_ready () {
+                    return _p.await_ready();}
+
+                void await_suspend (std::coroutine_handle<> h) {
+                    _p.await_suspend(h);}
+
+                std::size_t await_resume () {
+                    std::optional<T> v = _p.await_resume();
+                    if (!v)
+                        return 0;
+                    _out.push_back(*v);
+                    std::size_t n = 1;
+                    std::lock_guard<std::mutex> l(_c._m);
+                    while ((n != _max) && (!_c._buffer.empty() || !_c._senders.empty())) {
+                        _out.push_back(_c.take());
+                        ++n;}
+                    return n;}};
+
+    public:
+        /**
+         * @param e the executor that resumes waiters
+         * @param capacity a size_t, the most values buffered, UNBOUNDED by default
+         */
+        explicit MyChannel (MyExecutor& e, std::size_t capacity = UNBOUNDED)
+            : _e(e), _capacity(capacity), _closed(false) {}
+
+        /**
+         * @param v a const T reference
+         * @return an awaitable yielding true once v is in the channel, or false if it is closed
+         */
+        PushAwaiter push (const T& v) {
+            return PushAwaiter(*this, v);}
+
+        /**
+         * @return an awaitable yielding the next value, or nullopt once closed and drained
+         */
+        PopAwaiter pop () {
+            return PopAwaiter(*this);}
+
+        /**
+         * @param out a MyDeque reference
+         * @param max a size_t, at least 1
+         * @return an awaitable that waits for one value, then appends it and up to max - 1
+         * more that are ready to out, yielding how many; 0 once closed and drained
+         */
+        BatchAwaiter pop_batch (MyDeque<T>& out, std::size_t max) {
+            return BatchAwaiter(*this, out, max);}
+
+        /**
+         * Refuses further pushes and wakes every waiter; buffered values can still be popped
+         */
+        void close () {
+            std::unique_lock<std::mutex> l(_m);
+            _closed = true;
+            MyDeque<Receiver*> r;
+            MyDeque<Sender*>   s;
+            r.swap(_receivers);
+            s.swap(_senders);
+            l.unlock();
+            for (std::size_t i = 0; i != s.size(); ++i) {
+                s[i]->_ok = false;
+                _e.schedule(s[i]->_h);}
+            for (std::size_t i = 0; i != r.size(); ++i)
+                _e.schedule(r[i]->_h);}
+
+        /**
+         * @return a bool
+         */
+        bool closed () {
+            std::lock_guard<std::mutex> l(_m);
+            return _closed;}};
+
+#endif // Channel_h
@@ -0,0 +1,675 @@
+// --------------------------------
+// projects/deque/CompressedDeque.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// --------------------------------
+
+#ifndef CompressedDeque_h
+#define CompressedDeque_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // max, min
+#include <cassert> // assert
+#include <climits> // LLONG_MIN
+#include <cstdlib> // free, malloc
+#include <cstring> // memcpy, memset
+#include <new> // bad_alloc
+#include <set> // set
+#include <stdexcept> // out_of_range
+#include <type_traits> // is_integral
+
+#include <stdint.h> // uint64_t
+
+#include "Deque.h"
+#include "DequeBlocks.h"
+
+// -------------------
+// MyCompressionReport
+// -------------------
+
+/**
+ * What a MyCompressedDeque holds and what reading it has cost.
+ */
+struct MyCompressionReport {
+    std::size_t _elements;
+    std::size_t _hot;           // decoded blocks
+    std::size_t _cold;          // compressed blocks
+    std::size_t _raw;           // bytes the elements would take decoded
+    std::size_t _stored;        // bytes of decoded and compressed blocks
+    std::size_t _hits;          // reads of cold blocks found in the cache
+    std::size_t _misses;        // reads of cold blocks that decoded them
+
+    /**
+     * @return how many times smaller the deque is than its elements decoded
+     */
+    double ratio () const {
+        return _stored ? static_cast<double>(_raw) / _stored : 1;}};
+
+// -----------------
+// MyCompressedDeque
+// -----------------
+
+/**
+ * A deque of integers, such as timestamps and counters, that keeps at most
+ * a memory budget of its blocks decoded and compresses the rest in place.
+ * Each cold block is stored in whichever is smaller of two encodings:
+ *   DELTA  the first value and then each difference from the one before,
+ *          zigzagged and written as varints, for mostly monotone series;
+ *   FRAME  the minimum and then each value's offset from it, packed into
+ *          the fewest bits that hold the largest, for values in a range.
+ * The first and last blocks, where pushes and pops happen, stay decoded;
+ * a pop that leaves a compressed block at an end decodes it. When the
+ * budget is exceeded the least recently used other block is compressed.
+ * Reading a cold block through a const deque decodes it into a small cache
+ * of recently read blocks and leaves it compressed; reaching it through a
+ * non-const deque, which may write it, decodes it in place.
+ * References are valid until the next operation on the deque.
+ */
+template <typename T>
+class MyCompressedDeque {
+    static_assert(std::is_integral<T>::value, "MyCompressedDeque requires an integral T");
+
+    public:
+    // --------
+    // typedefs
+    // --------
+
+    typedef T           value_type;
+
+    typedef std::size_t    size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    typedef T*          pointer;
+    typedef const T*    const_pointer;
+
+    typedef T&          reference;
+    typedef const T&    const_reference;
+
+private:
+    // -----
+    // Block
+    // -----
+
+    /**
+     * Exactly one of _data, the decoded elements, and _code, the _bytes
+     * of the encoding, is set.
+     */
+    struct Block {
+        pointer        _data;
+        unsigned char* _code;
+        size_type      _bytes;
+        unsigned long  _used;
+
+        Block ()
+            : _data(0), _code(0), _bytes(0), _used(0) {}};
+
+    /**
+     * A decoded copy of the cold block _id.
+     */
+    struct Slot {
+        long long _id;
+        pointer   _data;};
+
+    enum {DELTA, FRAME};
+
+    static const long long NONE = LLONG_MIN;    // the id of an empty Slot
+
+private:
+    // ----
+    // data
+    // ----
+
+    BlockRing<Block> _ring;
+    const size_type  _budget;   // decoded blocks
+
+    std::set<long long> _hot;
+    unsigned long   _tick;
+    size_type       _stored;    // bytes of compressed blocks
+
+    MyDeque<Slot>   _cache;     // most recently read first
+    unsigned char*  _scratch;   // room for the longest encoding
+    size_type       _hits;
+    size_type       _misses;
+
+    private:
+        // -----
+        // bytes
+        // -----
+
+        size_type bytes () const {
+            return _ring._columns * sizeof(T);}
+
+        // ----
+        // make
+        // ----
+
+        /**
+         * @param n a size_type
+         * @return n bytes from malloc
+         */
+        static void* make (size_type n) {
+            void* p = std::malloc(n);
+            if (!p)
+                throw std::bad_alloc();
+            return p;}
+
+        // ------
+        // varint
+        // ------
+
+        static unsigned char* put (unsigned char* p, uint64_t x) {
+            while (x >= 0x80) {
+                *p++ = static_cast<unsigned char>(x | 0x80);
+                x >>= 7;}
+            *p++ = static_cast<unsigned char>(x);
+            return p;}
+
+        static const unsigned char* get (const unsigned char* p, uint64_t& x) {
+            x = 0;
+            for (unsigned s = 0; ; s += 7) {
+                const unsigned char c = *p++;
+                x |= static_cast<uint64_t>(c & 0x7F) << s;
+                if (!(c & 0x80))
+                    return p;}}
+
+        static uint64_t zigzag (uint64_t d) {
+            return (d << 1) ^ (0 - (d >> 63));}
+
+        static uint64_t unzigzag (uint64_t z) {
+            return (z >> 1) ^ (0 - (z & 1));}
+
+        // ----
+        // bits
+        // ----
+
+        /**
+         * @param p a zeroed buffer
+         * @param bit a size_type, the first bit to write
+         * @param x a uint64_t
+         * @param w an unsigned, the number of low bits of x to write
+         */
+        static void pack (unsigned char* p, size_type bit, uint64_t x, unsigned w) {
+            while (w) {
+                const unsigned o = bit & 7;
+                const unsigned n = std::min(8 - o, w);
+                p[bit >> 3] |= static_cast<unsigned char>((x & ((1U << n) - 1)) << o);
+                x >>= n;
+                bit += n;
+                w   -= n;}}
+
+        static uint64_t unpack (const unsigned char* p, size_type bit, unsigned w) {
+            uint64_t x = 0;
+            for (unsigned s = 0; s != w; ) {
+                const unsigned o = bit & 7;
+                const unsigned n = std::min(8 - o, w - s);
+                x |= static_cast<uint64_t>((p[bit >> 3] >> o) & ((1U << n) - 1)) << s;
+                bit += n;
+                s   += n;}
+            return x;}
+
+        // ------
+        // encode
+        // ------
+
+        /**
+         * @param d a pointer to _columns elements
+         * @return the length of the smaller encoding of d, left in _scratch
+         */
+        size_type encode (const_pointer d) {
+            unsigned char* p = _scratch;
+            *p++ = DELTA;
+            uint64_t prev = 0;
+            for (size_type i = 0; i != _ring._columns; ++i) {
+                const uint64_t v = static_cast<uint64_t>(static_cast<long long>(d[i]));
+                p = put(p, zigzag(v - prev));
+                prev = v;}
+            const size_type delta = p - _scratch;
+
+            long long lo = d[0];
+            long long hi = d[0];
+            for (size_type i = 1; i != _ring._columns; ++i) {
+                lo = std::min<long long>(lo, d[i]);
+                hi = std::max<long long>(hi, d[i]);}
+            const uint64_t range = static_cast<uint64_t>(hi) - static_cast<uint64_t>(lo);
+            unsigned w = 0;
+            while ((w != 64) && (range >> w))
+                ++w;
+            const size_type frame = 2 + sizeof(uint64_t) + (_ring._columns * w + 7) / 8;
+            if (frame >= delta)
+                return delta;
+
+            p = _scratch;
+            std::memset(p, 0, frame);
+            *p++ = FRAME;
+            *p++ = static_cast<unsigned char>(w);
+            std::memcpy(p, &lo, sizeof(lo));
+            p += sizeof(lo);
+            for (size_type i = 0; i != _ring._columns; ++i)
+                pack(p, i * w, static_cast<uint64_t>(static_cast<long long>(d[i])) - static_cast<uint64_t>(lo), w);
+            return frame;}
+
+        // ------
+        // decode
+        // ------
+
+        /**
+         * @param p an encoding of _columns elements
+         * @param d a pointer to room for them
+         */
+        void decode (const unsigned char* p, pointer d) const {
+            if (*p++ == DELTA) {
+                uint64_t prev = 0;
+                for (size_type i = 0; i != _ring._columns; ++i) {
+                    uint64_t z;
+                    p = get(p, z);
+                    prev += unzigzag(z);
+                    d[i] = static_cast<T>(prev);}
+                return;}
+            const unsigned w = *p++;
+            long long lo;
+            std::memcpy(&lo, p, sizeof(lo));
+            p += sizeof(lo);
+            for (size_type i = 0; i != _ring._columns; ++i)
+                d[i] = static_cast<T>(static_cast<uint64_t>(lo) + unpack(p, i * w, w));}
+
+        // --------
+        // compress
+        // --------
+
+        /**
+         * @param id a long long, the id of a decoded block
+         * Replaces the block's elements with their encoding
+         */
+        void compress (long long id) {
+            Block* b = _ring._blocks[id - _ring._first];
+            assert(b->_data);
+            const size_type n = encode(b->_data);
+            b->_code = static_cast<unsigned char*>(make(n));
+            std::memcpy(b->_code, _scratch, n);
+            b->_bytes = n;
+            std::free(b->_data);
+            b->_data = 0;
+            _stored += n;
+            _hot.erase(id);}
+
+        // -----
+        // evict
+        // -----
+
+        /**
+         * @param pin a long long, the id of a block that must stay decoded
+         * Compresses the least recently used interior blocks until the budget is met
+         */
+        void evict (long long pin) {
+            const long long front = _ring._first;
+            const long long back  = _ring.last();
+            while (_hot.size() > _budget) {
+                long long victim = pin;
+                unsigned long used = ~0UL;
+                for (std::set<long long>::const_iterator p = _hot.begin(); p != _hot.end(); ++p) {
+                    const long long id = *p;
+                    if ((id == front) || (id == back) || (id == pin))
+                        continue;
+                    if (_ring._blocks[id - _ring._first]->_used < used) {
+                        victim = id;
+                        used   = _ring._blocks[id - _ring._first]->_used;}}
+                if (victim == pin)
+                    return;
+                compress(victim);}}
+
+        // ------
+        // forget
+        // ------
+
+        /**
+         * @param id a long long
+         * Drops the cached copy of block id, if any
+         */
+        void forget (long long id) {
+            for (size_type i = 0; i != _cache.size(); ++i)
+                if (_cache[i]._id == id)
+                    _cache[i]._id = NONE;}
+
+        // -----
+        // block
+        // -----
+
+        /**
+         * @param k a size_type, a position in _blocks
+         * @return the block's elements, decoding it in place if it was compressed
+         */
+        pointer block (size_type k) {
+            Block* b = _ring._blocks[k];
+            b->_used = ++_tick;
+            if (!b->_data) {
+                b->_data = static_cast<pointer>(make(bytes()));
+                decode(b->_code, b->_data);
+                std::free(b->_code);
+                _stored -= b->_bytes;
+                b->_code  = 0;
+                b->_bytes = 0;
+                forget(_ring._first + k);
+                _hot.insert(_ring._first + k);
+                evict(_ring._first + k);}
+            return b->_data;}
+
+        // ----
+        // read
+        // ----
+
+        /**
+         * @param k a size_type, a position in _blocks
+         * @return the block's elements, from the cache if it is compressed
+         */
+        const_pointer read (size_type k) {
+            Block* b = _ring._blocks[k];
+            if (b->_data) {
+                b->_used = ++_tick;
+                return b->_data;}
+            const long long id = _ring._first + k;
+            for (size_type i = 0; i != _cache.size(); ++i)
+                if (_cache[i]._id == id) {
+                    ++_hits;
+                    const Slot s = _cache[i];
+                    for (; i != 0; --i)
+                        _cache[i] = _cache[i - 1];
+                    _cache[0] = s;
+                    return s._data;}
+            ++_misses;
+            Slot s = _cache.back();
+            _cache.pop_back();
+            decode(b->_code, s._data);
+            s._id = id;
+            _cache.push_front(s);
+            return s._data;}
+
+        // ----
+        // open
+        // ----
+
+        void open (Block* b) {
+            b->_data = static_cast<pointer>(make(bytes()));}
+
+        // ------
+        // opened
+        // ------
+
+        void opened (long long id) {
+            _ring._blocks[id - _ring._first]->_used = ++_tick;
+            _hot.insert(id);
+            evict(id);}
+
+        // ----
+        // drop
+        // ----
+
+        void drop (size_type k) {
+            Block* b = _ring._blocks[k];
+            if (b->_data) {
+                std::free(b->_data);
+                _hot.erase(_ring._first + k);}
+            else {
+                std::free(b->_code);
+                _stored -= b->_bytes;
+                forget(_ring._first + k);}}
+
+        // -----
+        // ended
+        // -----
+
+        /**
+         * @param k a size_type, a position in _blocks
+         * Decodes a block that a pop has left at an end, so the pushes and
+         * pops that follow don't have to; if there's no memory to, the
+         * block is decoded when it is next written
+         */
+        void ended (size_type k) {
+            try {
+                block(k);}
+            catch (const std::bad_alloc&) {}}
+
+        // -----
+        // write
+        // -----
+
+        pointer write (size_type k) {
+            return block(k);}
+
+    private:
+        friend struct BlockRing<Block>;
+
+        // Not copyable: the blocks are owned.
+        MyCompressedDeque (const MyCompressedDeque&);
+        MyCompressedDeque& operator = (const MyCompressedDeque&);
+
+    public:
+        // ------------
+        // constructors
+        // ------------
+
+        /**
+         * @param budget a size_type, the bytes of blocks to keep decoded
+         * @param cache a size_type, the number of cold blocks to keep a decoded copy of
+         * @param block a size_type, the bytes per block
+         * The budget is raised if needed to cover the first and last blocks.
+         */
+        explicit MyCompressedDeque (size_type budget = 1 << 20, size_type cache = 4, size_type block = 8 << 10)
+            : _ring((block / sizeof(T)) ? (block / sizeof(T)) : 1),
+              _budget(std::max<size_type>(budget / (_ring._columns * sizeof(T)), 2)),
+              _hot(), _tick(0), _stored(0),
+              _cache(), _scratch(0), _hits(0), _misses(0) {
+            try {
+                _scratch = static_cast<unsigned char*>(make(1 + _ring._columns * 10));
+                for (size_type i = 0; i != std::max<size_type>(cache, 1); ++i) {
+                    const Slot s = {NONE, 0};
+                    _cache.push_back(s);
+                    _cache.back()._data = static_cast<pointer>(make(bytes()));}}
+            catch (...) {
+                for (size_type i = 0; i != _cache.size(); ++i)
+                    std::free(_cache[i]._data);
+                std::free(_scratch);
+                throw;}
+            assert(_ring.valid());}
+
+        // ----------
+        // destructor
+        // ----------
+
+        ~MyCompressedDeque () {
+            for (size_type k = 0; k != _ring._blocks.size(); ++k) {
+                std::free(_ring._blocks[k]->_data);
+                std::free(_ring._blocks[k]->_code);
+                delete _ring._blocks[k];}
+            for (size_type i = 0; i != _cache.size(); ++i)
+                std::free(_cache[i]._data);
+            std::free(_scratch);}
+
+        // -----------
+        // operator []
+        // -----------
+
+        /**
+         * @param index a size_type
+         * @return a reference, decoding the element's block in place
+         */
+        reference operator [] (size_type index) {
+            const size_type i = _ring._head + index;
+            return block(i / _ring._columns)[i % _ring._columns];}
+
+        /**
+         * @param index a size_type
+         * @return a const reference, valid until the next operation on this deque
+         */
+        const_reference operator [] (size_type index) const {
+            MyCompressedDeque* d = const_cast<MyCompressedDeque*>(this);
+            const size_type i = _ring._head + index;
+            return d->read(i / _ring._columns)[i % _ring._columns];}
+
+        // --
+        // at
+        // --
+
+        /**
+         * @param index a size_type
+         * @return a reference
+         * Throw if index is out of bounds
+         */
+        reference at (size_type index) {
+            if (index >= size())
+                throw std::out_of_range("Out of bounds.");
+            return (*this)[index];}
+
+        /**
+         * @param index a size_type
+         * @return a const_reference
+         */
+        const_reference at (size_type index) const {
+            if (index >= size())
+                throw std::out_of_range("Out of bounds.");
+            return (*this)[index];}
+
+        // ----
+        // back
+        // ----
+
+        /**
+         * @return a reference to the last element
+         */
+        reference back () {
+            assert(size() != 0);
+            return (*this)[_ring._size - 1];}
+
+        /**
+         * @return a const reference to the last element
+         */
+        const_reference back () const {
+            assert(size() != 0);
+            return (*this)[_ring._size - 1];}
+
+        // -----
+        // clear
+        // -----
+
+        /**
+         * Drops every element and block
+         */
+        void clear () {
+            _ring.clear(*this);
+            assert(_ring.valid());}
+
+        // -------
+        // compact
+        // -------
+
+        /**
+         * Compresses every block but the first and the last, now
+         */
+        void compact () {
+            const long long front = _ring._first;
+            const long long back  = _ring.last();
+            MyDeque<long long> hot;
+            for (std::set<long long>::const_iterator p = _hot.begin(); p != _hot.end(); ++p)
+                hot.push_back(*p);
+            for (size_type i = 0; i != hot.size(); ++i)
+                if ((hot[i] != front) && (hot[i] != back))
+                    compress(hot[i]);}
+
+        // -----
+        // empty
+        // -----
+
+        /**
+         * @return a bool
+         */
+        bool empty () const {
+            return !size();}
+
+        // -----
+        // front
+        // -----
+
+        /**
+         * @return a reference to the first element
+         */
+        reference front () {
+            assert(size() != 0);
+            return (*this)[0];}
+
+        /**
+         * @return a const_reference to the first element
+         */
+        const_reference front () const {
+            assert(size() != 0);
+            return (*this)[0];}
+
+        // --------
+        // pop_back
+        // --------
+
+        /**
+         * Removes the back element
+         */
+        void pop_back () {
+            assert(size() != 0);
+            _ring.pop_back(*this);
+            assert(_ring.valid());}
+
+        // ---------
+        // pop_front
+        // ---------
+
+        /**
+         * Removes the front element
+         */
+        void pop_front () {
+            assert(size() != 0);
+            _ring.pop_front(*this);
+            assert(_ring.valid());}
+
+        // ---------
+        // push_back
+        // ---------
+
+        /**
+         * @param v a const_reference
+         */
+        void push_back (const_reference v) {
+            _ring.push_back(*this, value_type(v));
+            assert(_ring.valid());}
+
+        // ----------
+        // push_front
+        // ----------
+
+        /**
+         * @param v a const_reference
+         */
+        void push_front (const_reference v) {
+            _ring.push_front(*this, value_type(v));
+            assert(_ring.valid());}
+
+        // ------
+        // report
+        // ------
+
+        /**
+         * @return the blocks, their bytes, and the cache hits and misses so far
+         */
+        MyCompressionReport report () const {
+            const MyCompressionReport r = {_ring._size, _hot.size(), _ring._blocks.size() - _hot.size(), _ring._size * sizeof(T), _hot.size() * bytes() + _stored, _hits, _misses};
+            return r;}
+
+        // ----
+        // size
+        // ----
+
+        /**
+         * @return a size_type
+         */
+        size_type size () const {
+            return _ring._size;}};
+
+#endif // CompressedDeque_h
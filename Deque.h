@@ -13,13 +13,26 @@
 // includes
 // --------
 
-#include <algorithm> // copy, equal, lexicographical_compare, max, swap
+#include <algorithm> // copy, copy_backward, equal, lexicographical_compare, max, swap
 #include <cassert> // assert
-#include <iterator> // iterator, bidirectional_iterator_tag
-#include <memory> // allocator
+#include <cstddef> // size_t
+#include <exception> // current_exception, exception_ptr, rethrow_exception
+#include <functional> // less
+#include <initializer_list> // initializer_list
+#include <iterator> // advance, distance, iterator, iterator_traits, random_access_iterator_tag
+#include <memory> // allocator, allocator_traits
 #include <stdexcept> // out_of_range
+#include <thread> // thread
+#include <type_traits> // enable_if, is_integral
 #include <utility> // !=, <=, >, >=
 
+#include "DequeSort.h"
+
+/**
+ * The fewest elements construct_blocks gives a thread of its own.
+ */
+const std::size_t FILL_RUN = 65536;
+
 // -----
 // using
 // -----
@@ -39,7 +52,7 @@ template <typename A, typename BI>
 BI destroy (A& a, BI b, BI e) {
     while (b != e) {
         --e;
-        a.destroy(&*e);}
+        std::allocator_traits<A>::destroy(a, &*e);}
     return b;}
 
 // ------------------
@@ -50,7 +63,7 @@ BI uninitialized_copy (A& a, II b, II e, BI x) {
     assert(b!=e);
     try {
         while (b != e) {
-            a.construct(&*x, *b);
+            std::allocator_traits<A>::construct(a, &*x, *b);
             ++b;
             ++x;}}
     catch (...) {
@@ -66,7 +79,7 @@ template <typename A, typename BI, typename U>
     assert(p == b);
     try {
         while (b != e) {
-            a.construct(&*b, v);
+            std::allocator_traits<A>::construct(a, &*b, v);
             ++b;}}
     catch (...) {
         destroy(a, p, b);
@@ -85,18 +98,17 @@ class MyDeque {
     // --------
 
     typedef A   allocator_type;
-    typedef typename allocator_type::value_type value_type; // T
-
-    typedef typename allocator_type::size_type  size_type;
-    typedef typename allocator_type::difference_type    difference_type;
+    typedef std::allocator_traits<allocator_type>   allocator_traits_type;
+    typedef typename allocator_traits_type::value_type value_type; // T
 
-    typedef typename allocator_type::pointer    pointer;    // T*
-    typedef typename allocator_type::const_pointer  const_pointer;
+    typedef typename allocator_traits_type::size_type  size_type;
+    typedef typename allocator_traits_type::difference_type    difference_type;
 
-    typedef typename allocator_type::reference  reference;
-    typedef typename allocator_type::const_reference    const_reference;
+    typedef typename allocator_traits_type::pointer    pointer;    // T*
+    typedef typename allocator_traits_type::const_pointer  const_pointer;
 
-    typedef typename allocator_type::template rebind<T*>::other allocatorPointer_type;
+    typedef value_type&  reference;
+    typedef const value_type&    const_reference;
 
 public:
     // -----------
@@ -133,9 +145,6 @@ private:
     // ----
 
     allocator_type _a; 
-    allocatorPointer_type _aPointer; 
-
-    pointer* _outerFront;    
 
     pointer _front;  
     pointer _back; 
@@ -150,6 +159,266 @@ private:
         bool valid () const {
             return (!_front && !_back && !_b && !_e) || ((_front <= _b) && (_b <= _e) && (_e <= _back));}
 
+        // Bulk readers in DequeStream.h fill the slack past _e directly.
+        template <typename D>
+        friend struct DequeIO;
+
+        // --------
+        // relocate
+        // --------
+
+        /**
+         * @param c a size_type, the capacity to end up with
+         * @param o a size_type, the offset of the front element in it
+         * Copies the elements to [o, o + size()) of a new buffer of c elements,
+         * or of this one if c is its capacity, then destroys the originals;
+         * in place, the two ranges must not overlap
+         */
+        void relocate (size_type c, size_type o) {
+            const size_type s    = size();
+            const bool      same = (c == (size_type)(_back - _front));
+            pointer p = same ? _front : _a.allocate(c);
+            assert(!same || (p + o + s <= _b) || (_e <= p + o));
+            if (s) {
+                try {
+                    uninitialized_copy(_a, _b, _e, p + o);}
+                catch (...) {
+                    if (!same)
+                        _a.deallocate(p, c);
+                    throw;}
+                destroy(_a, _b, _e);}
+            if (!same) {
+                if (_front)
+                    _a.deallocate(_front, _back - _front);
+                _front = p;
+                _back  = p + c;}
+            _b = p + o;
+            _e = _b + s;
+            assert(valid());}
+
+        // ------------
+        // reserve_back
+        // ------------
+
+        /**
+         * @param n a size_type
+         * @return a pointer to room for n elements past the back, not constructed
+         * If there isn't room already, recenters the elements in place when they
+         * fill at most a quarter of the capacity, or else reallocates to
+         * max(2 * capacity, size() + n), centered; so a FIFO stops allocating
+         * once its capacity is four times its length
+         */
+        pointer reserve_back (size_type n) {
+            if ((size_type)(_back - _e) >= n)
+                return _e;
+            const size_type s = size();
+            size_type       c = _back - _front;
+            if (4 * (s + n) > c)
+                c = std::max(2 * c, s + n);
+            relocate(c, (c - s - n) / 2);
+            return _e;}
+
+        // -------------
+        // reserve_front
+        // -------------
+
+        /**
+         * @param n a size_type
+         * @return a pointer just past room for n elements before the front, not constructed
+         * The mirror image of reserve_back
+         */
+        pointer reserve_front (size_type n) {
+            if ((size_type)(_b - _front) >= n)
+                return _b;
+            const size_type s = size();
+            size_type       c = _back - _front;
+            if (4 * (s + n) > c)
+                c = std::max(2 * c, s + n);
+            relocate(c, n + (c - s - n) / 2);
+            return _b;}
+
+        // ----
+        // Fill
+        // ----
+
+        /**
+         * Constructs elements [i, j) of a block as copies of one value.
+         */
+        struct Fill {
+            allocator_type*   _a;
+            const value_type* _v;
+
+            void operator () (pointer p, size_type i, size_type j) const {
+                uninitialized_fill(*_a, p + i, p + j, *_v);}};
+
+        // ----
+        // Copy
+        // ----
+
+        /**
+         * Constructs elements [i, j) of a block as copies of [_b + i, _b + j).
+         */
+        template <typename FI>
+        struct Copy {
+            allocator_type* _a;
+            FI              _b;
+
+            void operator () (pointer p, size_type i, size_type j) const {
+                if (i == j)
+                    return;
+                FI b = _b;
+                std::advance(b, i);
+                FI e = b;
+                std::advance(e, j - i);
+                uninitialized_copy(*_a, b, e, p + i);}};
+
+        // ----------------
+        // construct_blocks
+        // ----------------
+
+        /**
+         * @param p a pointer to room for n elements, not constructed
+         * @param n a size_type
+         * @param f a Fill or a Copy
+         * @param threads an unsigned
+         * Constructs [p, p + n) with f in one block per thread, of at least
+         * FILL_RUN elements, so each thread is the first to touch the pages of
+         * its block and the kernel places them on that thread's node. This
+         * thread takes the first block, and any a new thread can't be started
+         * for. If a block throws, destroys the others and rethrows.
+         */
+        template <typename F>
+        void construct_blocks (pointer p, size_type n, const F& f, unsigned threads) {
+            const size_type k = std::max<size_type>(1, std::min<size_type>(threads, n / FILL_RUN));
+            if (k == 1) {
+                f(p, 0, n);
+                return;}
+
+            struct Block {
+                const F*            _f;
+                pointer             _p;
+                size_type           _n;
+                size_type           _k;
+                std::exception_ptr* _x;
+
+                void operator () (size_type j) const {
+                    try {
+                        (*_f)(_p, _n * j / _k, _n * (j + 1) / _k);}
+                    catch (...) {
+                        _x[j] = std::current_exception();}}};
+            SortArray<std::exception_ptr> x(k);
+            const Block block = {&f, p, n, k, x._p};
+            {
+            SortArray<std::thread> w(k);
+            size_type started = 1;
+            try {
+                for (; started != k; ++started)
+                    w[started] = std::thread(block, started);}
+            catch (...) {}
+            block(0);
+            for (size_type j = started; j != k; ++j)
+                block(j);
+            for (size_type j = 1; j != started; ++j)
+                w[j].join();
+            }
+            for (size_type j = 0; j != k; ++j)
+                if (x[j]) {
+                    for (size_type i = 0; i != k; ++i)
+                        if (!x[i])
+                            destroy(_a, p + n * i / k, p + n * (i + 1) / k);
+                    std::rethrow_exception(x[j]);}}
+
+        // -----
+        // build
+        // -----
+
+        /**
+         * @param n a size_type
+         * @param f a Fill or a Copy
+         * @param threads an unsigned
+         * Replaces the elements with n constructed by f, centered in the
+         * current buffer if they fit, or else in a new one of exactly n
+         */
+        template <typename F>
+        void build (size_type n, const F& f, unsigned threads) {
+            if (n > (size_type)(_back - _front)) {
+                pointer p = _a.allocate(n);
+                try {
+                    construct_blocks(p, n, f, threads);}
+                catch (...) {
+                    _a.deallocate(p, n);
+                    throw;}
+                clear();
+                if (_front)
+                    _a.deallocate(_front, _back - _front);
+                _front = _b = p;
+                _back  = _e = p + n;}
+            else {
+                clear();
+                pointer p = _front + (_back - _front - n) / 2;
+                construct_blocks(p, n, f, threads);
+                _b = p;
+                _e = p + n;}
+            assert(valid());}
+
+        // ------
+        // assign
+        // ------
+
+        template <typename II>
+        void assign (II b, II e, unsigned, std::input_iterator_tag) {
+            clear();
+            for (; b != e; ++b)
+                push_back(*b);}
+
+        template <typename FI>
+        void assign (FI b, FI e, unsigned threads, std::forward_iterator_tag) {
+            const Copy<FI> f = {&_a, b};
+            build(std::distance(b, e), f, threads);}
+
+        // -------
+        // sort_by
+        // -------
+
+        /**
+         * @param c a comparator
+         * @param stable a bool
+         * @param threads an unsigned
+         * Sorts the elements with sort_runs, using a copy of them as scratch,
+         * and keeps whichever buffer ends up sorted. A single run that isn't
+         * a radix sort is sorted in place, without the copy.
+         */
+        template <typename C>
+        void sort_by (C c, bool stable, unsigned threads) {
+            const size_type s = size();
+            if (s < 2)
+                return;
+            if (!is_radix<value_type, C>::value && ((threads < 2) || (s / SORT_RUN < 2))) {
+                sort_runs(&*_b, static_cast<value_type*>(0), s, c, stable, 1);
+                return;}
+            pointer t = _a.allocate(s);
+            try {
+                uninitialized_copy(_a, _b, _e, t);}
+            catch (...) {
+                _a.deallocate(t, s);
+                throw;}
+            pointer r;
+            try {
+                r = sort_runs(&*_b, &*t, s, c, stable, threads);}
+            catch (...) {
+                destroy(_a, t, t + s);
+                _a.deallocate(t, s);
+                throw;}
+            if (r == &*_b) {
+                destroy(_a, t, t + s);
+                _a.deallocate(t, s);}
+            else {
+                destroy(_a, _b, _e);
+                _a.deallocate(_front, _back - _front);
+                _front = _b = t;
+                _back  = _e = t + s;}
+            assert(valid());}
+
     public:
         // --------
         // iterator
@@ -161,7 +430,7 @@ private:
                 // typedefs
                 // --------
 
-                typedef std::bidirectional_iterator_tag   iterator_category;
+                typedef std::random_access_iterator_tag   iterator_category;
                 typedef typename MyDeque::value_type      value_type;
                 typedef typename MyDeque::difference_type difference_type;
                 typedef typename MyDeque::pointer         pointer;
@@ -207,6 +476,15 @@ private:
                 friend iterator operator + (iterator lhs, difference_type rhs) {
                     return lhs += rhs;}
 
+                /**
+                 * @param lhs a difference_type
+                 * @param rhs an iterator
+                 * @return an iterator
+                 * (lhs + rhs) => iterator
+                 */
+                friend iterator operator + (difference_type lhs, iterator rhs) {
+                    return rhs += lhs;}
+
                 // ----------
                 // operator -
                 // ----------
@@ -221,6 +499,30 @@ private:
                 friend iterator operator - (iterator lhs, difference_type rhs) {
                     return lhs -= rhs;}
 
+                /**
+                 * @param lhs a const iterator reference
+                 * @param rhs a const iterator reference
+                 * @return the difference_type distance from rhs to lhs
+                 * (lhs - rhs) => difference_type
+                 */
+                friend difference_type operator - (const iterator& lhs, const iterator& rhs) {
+                    assert(lhs._deque == rhs._deque);
+                    return static_cast<difference_type>(lhs._idx) - static_cast<difference_type>(rhs._idx);}
+
+                // ----------
+                // operator <
+                // ----------
+
+                /**
+                 * @param lhs a const iterator reference
+                 * @param rhs a const iterator reference
+                 * @return true if lhs is before rhs
+                 * The other orderings come from rel_ops
+                 */
+                friend bool operator < (const iterator& lhs, const iterator& rhs) {
+                    assert(lhs._deque == rhs._deque);
+                    return lhs._idx < rhs._idx;}
+
             private:
                 // ----
                 // data
@@ -349,7 +651,18 @@ private:
                 iterator& operator -= (difference_type d) {
                     _idx -= d;
                     assert(valid());
-                    return *this;}};
+                    return *this;}
+
+                // -----------
+                // operator []
+                // -----------
+
+                /**
+                 * @param d a difference_type
+                 * @return a reference to the element d past this
+                 */
+                reference operator [] (difference_type d) const {
+                    return *(*this + d);}};
 
     public:
         // --------------
@@ -360,7 +673,7 @@ private:
             public:
             // --------
             // typedefs
-            typedef std::bidirectional_iterator_tag   iterator_category;
+            typedef std::random_access_iterator_tag   iterator_category;
             typedef typename MyDeque::value_type      value_type;
             typedef typename MyDeque::difference_type difference_type;
             typedef typename MyDeque::const_pointer   pointer;
@@ -406,6 +719,15 @@ private:
                 friend const_iterator operator + (const_iterator lhs, difference_type rhs) {
                     return lhs += rhs;}
 
+                /**
+                 * @param lhs a difference_type
+                 * @param rhs a const_iterator
+                 * @return a const_iterator
+                 * (lhs + rhs) => const_iterator
+                 */
+                friend const_iterator operator + (difference_type lhs, const_iterator rhs) {
+                    return rhs += lhs;}
+
                 // ----------
                 // operator -
                 // ----------
@@ -420,6 +742,30 @@ private:
                 friend const_iterator operator - (const_iterator lhs, difference_type rhs) {
                     return lhs -= rhs;}
 
+                /**
+                 * @param lhs a const const_iterator reference
+                 * @param rhs a const const_iterator reference
+                 * @return the difference_type distance from rhs to lhs
+                 * (lhs - rhs) => difference_type
+                 */
+                friend difference_type operator - (const const_iterator& lhs, const const_iterator& rhs) {
+                    assert(lhs._cDeque == rhs._cDeque);
+                    return static_cast<difference_type>(lhs._idx) - static_cast<difference_type>(rhs._idx);}
+
+                // ----------
+                // operator <
+                // ----------
+
+                /**
+                 * @param lhs a const const_iterator reference
+                 * @param rhs a const const_iterator reference
+                 * @return true if lhs is before rhs
+                 * The other orderings come from rel_ops
+                 */
+                friend bool operator < (const const_iterator& lhs, const const_iterator& rhs) {
+                    assert(lhs._cDeque == rhs._cDeque);
+                    return lhs._idx < rhs._idx;}
+
             private:
                 // ----
                 // data
@@ -548,7 +894,18 @@ private:
             const_iterator& operator -= (difference_type rhs) {
                 _idx -= rhs;
                 assert(valid());
-                return *this;}};
+                return *this;}
+
+            // -----------
+            // operator []
+            // -----------
+
+            /**
+             * @param d a difference_type
+             * @return a const reference to the element d past this
+             */
+            reference operator [] (difference_type d) const {
+                return *(*this + d);}};
 
     public:
         // ------------
@@ -560,7 +917,7 @@ private:
          * Default constructor
          */
         explicit MyDeque (const allocator_type& a = allocator_type() )
-            : _a(a), _aPointer(), _outerFront(0), _front(0), _back(0), _b(0), _e(0) {
+            : _a(a), _front(0), _back(0), _b(0), _e(0) {
             assert(valid() );}
 
         /**
@@ -570,35 +927,36 @@ private:
          * Constructor with size specification
          */
         explicit MyDeque (size_type s, const_reference v = value_type(), const allocator_type& a = allocator_type())
-            : _a(a), _aPointer() {
-            size_type rows = s / COLUMNS;
-            if (s % COLUMNS != 0)
-                ++rows;
-            _outerFront = _aPointer.allocate(rows);
-            
-            for (size_type i = 0; i < rows; ++i) 
-                _outerFront[i] = _a.allocate(COLUMNS);
-            
-            for (size_type i = 0; i < rows; ++i) 
-                _a.deallocate(_outerFront[i], COLUMNS);
-            
-            _aPointer.deallocate(_outerFront, rows);
-            _front = _b = _a.allocate(s);
-            _e = _back = _b + s;
-            uninitialized_fill(_a, begin(), end(), v);
-            assert(valid());}
+            : _a(a), _front(0), _back(0), _b(0), _e(0) {
+            const Fill f = {&_a, &v};
+            build(s, f, 1);}
+
+        /**
+         * @param b an input iterator
+         * @param e an input iterator
+         * @param a a const allocator_type reference that is defaulted
+         * Constructor from a range, allocating once if it can be walked twice
+         */
+        template <typename II, typename = typename std::enable_if<!std::is_integral<II>::value>::type>
+        MyDeque (II b, II e, const allocator_type& a = allocator_type())
+            : _a(a), _front(0), _back(0), _b(0), _e(0) {
+            assign(b, e);}
+
+        /**
+         * @param l an initializer_list
+         * @param a a const allocator_type reference that is defaulted
+         */
+        MyDeque (std::initializer_list<value_type> l, const allocator_type& a = allocator_type())
+            : _a(a), _front(0), _back(0), _b(0), _e(0) {
+            assign(l.begin(), l.end());}
 
         /**
          * @param that a const MyDeque reference
          * Copy constructor
          */
         MyDeque (const MyDeque& that)
-            : _a(that._a), _aPointer() {
-            _outerFront = 0; 
-            _front = _b = _a.allocate(that.size());
-            _e = _back = _front + that.size();
-            uninitialized_copy(_a, that.begin(), that.end(), begin());
-            assert(valid());}
+            : _a(that._a), _front(0), _back(0), _b(0), _e(0) {
+            assign(that._b, that._e);}
 
         // ----------
         // destructor
@@ -664,6 +1022,40 @@ private:
         const_reference operator [] (size_type index) const {
             return const_cast<MyDeque*>(this)->operator[](index);}
 
+        // ------
+        // assign
+        // ------
+
+        /**
+         * @param n a size_type
+         * @param v a const_reference
+         * @param threads an unsigned that is defaulted
+         * Replaces the elements with n copies of v, reusing the buffer if they
+         * fit and otherwise allocating exactly n; with threads > 1, large
+         * counts are filled by up to that many threads (see construct_blocks)
+         */
+        void assign (size_type n, const_reference v, unsigned threads = 1) {
+            const value_type t(v);
+            const Fill f = {&_a, &t};
+            build(n, f, threads);}
+
+        /**
+         * @param b an input iterator
+         * @param e an input iterator
+         * @param threads an unsigned that is defaulted
+         * Replaces the elements with [b, e); a forward range is measured first,
+         * so storage is sized once, and copied by up to threads threads
+         */
+        template <typename II>
+        typename std::enable_if<!std::is_integral<II>::value>::type assign (II b, II e, unsigned threads = 1) {
+            assign(b, e, threads, typename std::iterator_traits<II>::iterator_category());}
+
+        /**
+         * @param l an initializer_list
+         */
+        void assign (std::initializer_list<value_type> l) {
+            assign(l.begin(), l.end());}
+
         // --
         // at
         // --
@@ -781,7 +1173,7 @@ private:
             else
                 pop_back();
             assert(valid() );
-            return iterator(this, 0);}
+            return i;}
 
         // -----
         // front
@@ -813,14 +1205,60 @@ private:
          */
         iterator insert (iterator i, const_reference v) {
             if(i != end()) {
+                const value_type t(v);
                 resize(size() + 1);
-                copy(i, end(), i + 1);
-                *i = v;
+                copy_backward(i, end() - 1, end());
+                *i = t;
             }
             else
                 push_back(v);
             assert(valid());
-            return iterator(this);}
+            return i;}
+
+        // -----
+        // merge
+        // -----
+
+        /**
+         * @param that a MyDeque rvalue reference, sorted
+         * Merges the elements of that into this, which is also sorted,
+         * leaving that empty; equal elements of this come first
+         */
+        void merge (MyDeque&& that) {
+            merge(std::move(that), std::less<value_type>());}
+
+        /**
+         * @param that a MyDeque rvalue reference, sorted by c
+         * @param c a comparator
+         */
+        template <typename C>
+        void merge (MyDeque&& that, C c) {
+            if ((this == &that) || that.empty())
+                return;
+            const size_type s = size() + that.size();
+            pointer t = _a.allocate(s);
+            pointer p = t;
+            try {
+                pointer i = _b;
+                pointer j = that._b;
+                while ((i != _e) && (j != that._e)) {
+                    allocator_traits_type::construct(_a, p, c(*j, *i) ? *j++ : *i++);
+                    ++p;}
+                for (; i != _e; ++i, ++p)
+                    allocator_traits_type::construct(_a, p, *i);
+                for (; j != that._e; ++j, ++p)
+                    allocator_traits_type::construct(_a, p, *j);}
+            catch (...) {
+                destroy(_a, t, p);
+                _a.deallocate(t, s);
+                throw;}
+            clear();
+            if (_front)
+                _a.deallocate(_front, _back - _front);
+            _front = _b = t;
+            _back  = _e = t + s;
+            that.clear();
+            assert(valid());}
 
         // --------
         // pop_back
@@ -831,7 +1269,8 @@ private:
         */
         void pop_back () {
             assert(size() != 0);
-            resize(size() - 1);
+            --_e;
+            allocator_traits_type::destroy(_a, _e);
             assert(valid());}
 
         /**
@@ -852,7 +1291,10 @@ private:
          * Pushes value v onto the back of MyDequeAppends a copy of v at the end
          */
         void push_back (const_reference v) {
-            resize(size() + 1, v);
+            const value_type t(v);
+            pointer p = reserve_back(1);
+            allocator_traits_type::construct(_a, p, t);
+            _e = p + 1;
             assert(valid());}
 
         // ----------
@@ -863,12 +1305,10 @@ private:
          * Pushes value v onto the front of MyDeque
          */
         void push_front (const_reference v) {
-            if (_front == _b) {
-                resize(size() + 1);
-                pop_back();
-            }    
-            --_b;
-            _a.construct(&*begin(), v); 
+            const value_type t(v);
+            pointer p = reserve_front(1) - 1;
+            allocator_traits_type::construct(_a, p, t);
+            _b = p;
             assert(valid());}
 
         // ------
@@ -884,28 +1324,11 @@ private:
             if (s == size())
                 return;
             if (s < size())
-                _e = &*destroy(_a, begin() + s, end() );
-            else if ((s <= (unsigned)(_e -_front)) && (s <= (unsigned)(_back - _b)))
-                _e = &*uninitialized_fill(_a, end(), begin() + s, v);
-            // Not large enough capacity
-            else { 
-                size_type c = 2 * size();
-                if (s > c)
-                    c = s;
-                if (c == s)
-                    c += 3;
-                size_type b_offset = (c - s) / 2;
-                size_type e_offset = b_offset;
-                if ((c - s) % 2)
-                    ++e_offset;
-                
-                MyDeque d(c, v);
-                copy(begin(), end(), d.begin() + b_offset);
-                destroy(d._a, d.begin(), d.begin() + b_offset);
-                destroy(d._a, d.end() - e_offset, d.end());
-                d._b += b_offset;
-                d._e -= e_offset;
-                swap(d);}
+                _e = destroy(_a, _b + s, _e);
+            else {
+                const value_type t(v);
+                reserve_back(s - size());
+                _e = uninitialized_fill(_a, _e, _b + s, t);}
             assert(valid());}
 
         // ----
@@ -918,6 +1341,46 @@ private:
         size_type size () const {
             return _e - _b;}
 
+        // ----
+        // sort
+        // ----
+
+        /**
+         * Sorts the elements by <, with a radix sort for integers
+         */
+        void sort () {
+            sort_by(std::less<value_type>(), false, 1);}
+
+        /**
+         * @param c a comparator
+         * @param threads an unsigned, the number of threads to sort with, 1 by default
+         * Sorts the elements by c. With more than one thread, each sorts a run
+         * of at least SORT_RUN elements, and then the threads merge the runs.
+         * If c throws, the elements are left in some order and the exception
+         * is rethrown once every thread is done.
+         */
+        template <typename C>
+        void sort (C c, unsigned threads = 1) {
+            sort_by(c, false, threads);}
+
+        // -----------
+        // stable_sort
+        // -----------
+
+        /**
+         * Sorts the elements by <, keeping equal elements in order
+         */
+        void stable_sort () {
+            sort_by(std::less<value_type>(), true, 1);}
+
+        /**
+         * @param c a comparator
+         * @param threads an unsigned, the number of threads to sort with, 1 by default
+         */
+        template <typename C>
+        void stable_sort (C c, unsigned threads = 1) {
+            sort_by(c, true, threads);}
+
         // ----
         // swap
         // ----
@@ -0,0 +1,223 @@
+// ----------------------------
+// projects/deque/DequeBlocks.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// ----------------------------
+
+#ifndef DequeBlocks_h
+#define DequeBlocks_h
+
+// --------
+// includes
+// --------
+
+#include <cstddef> // size_t
+
+#include "Deque.h"
+
+// ---------
+// BlockRing
+// ---------
+
+/**
+ * The blocks of a deque that keeps some of them out of memory, and where
+ * its elements lie in them. _blocks[k] has the id _first + k, which doesn't
+ * change as blocks come and go at the ends, so an id can name a block in a
+ * set of them. The owner D gives the blocks their storage through:
+ *   void open (B* b)            gives a new block room for its elements
+ *   void opened (long long id)  is told the new block id is in place
+ *   void drop (size_type k)     frees what _blocks[k] holds, before it goes
+ *   void ended (size_type k)    is told a pop has made _blocks[k] an end block
+ *   T* write (size_type k)      returns the elements of _blocks[k], to change
+ * open, opened and write may throw, and a push that they fail leaves the
+ * ring as it was; open must leave the block without storage if it throws.
+ * drop must not throw.
+ */
+template <typename B>
+struct BlockRing {
+    typedef std::size_t size_type;
+
+    const size_type _columns;   // elements per block
+
+    MyDeque<B*>     _blocks;
+    long long       _first;     // id of _blocks[0]; ids don't change as blocks come and go
+    size_type       _head;      // offset of the front element in _blocks[0]
+    size_type       _size;
+
+    explicit BlockRing (size_type columns)
+        : _columns(columns), _blocks(), _first(0), _head(0), _size(0) {}
+
+    // -----
+    // valid
+    // -----
+
+    bool valid () const {
+        return (_head < _columns) && ((_blocks.size() * _columns) >= (_head + _size)) && ((_blocks.size() == 0) || ((_blocks.size() - 1) * _columns < _head + _size));}
+
+    // ----
+    // last
+    // ----
+
+    /**
+     * @return the id of the back block
+     */
+    long long last () const {
+        return _first + static_cast<long long>(_blocks.size()) - 1;}
+
+    // ---
+    // add
+    // ---
+
+    /**
+     * @param d the owner
+     * @param front a bool
+     * Adds a block that d has given room at the front or the back,
+     * or, if d.open or d.opened throws, leaves the ring as it was
+     */
+    template <typename D>
+    void add (D& d, bool front) {
+        B* b = new B();
+        try {
+            if (front)
+                _blocks.push_front(b);
+            else
+                _blocks.push_back(b);}
+        catch (...) {
+            delete b;
+            throw;}
+        if (front)
+            --_first;
+        bool room = false;
+        try {
+            d.open(b);
+            room = true;
+            d.opened(front ? _first : last());}
+        catch (...) {
+            unadd(d, front, room);
+            throw;}}
+
+    // -----
+    // unadd
+    // -----
+
+    /**
+     * @param d the owner
+     * @param front a bool
+     * @param room a bool, true if d.open has given the block room
+     * Drops the block that add has just put at the front or the back
+     */
+    template <typename D>
+    void unadd (D& d, bool front, bool room) {
+        B* b = front ? _blocks.front() : _blocks.back();
+        if (room)
+            d.drop(front ? 0 : _blocks.size() - 1);
+        if (front) {
+            _blocks.pop_front();
+            ++_first;}
+        else
+            _blocks.pop_back();
+        delete b;}
+
+    // -------
+    // release
+    // -------
+
+    /**
+     * @param d the owner
+     * @param k a size_type, either 0 or the last position in _blocks
+     * Drops an empty block at one end
+     */
+    template <typename D>
+    void release (D& d, size_type k) {
+        B* b = _blocks[k];
+        d.drop(k);
+        delete b;
+        if (k == 0) {
+            _blocks.pop_front();
+            ++_first;}
+        else
+            _blocks.pop_back();}
+
+    // -----
+    // clear
+    // -----
+
+    template <typename D>
+    void clear (D& d) {
+        while (!_blocks.empty())
+            release(d, _blocks.size() - 1);
+        _head = _size = 0;}
+
+    // --------
+    // pop_back
+    // --------
+
+    template <typename D>
+    void pop_back (D& d) {
+        --_size;
+        if (_size == 0)
+            clear(d);
+        else if ((_blocks.size() - 1) * _columns >= _head + _size) {
+            release(d, _blocks.size() - 1);
+            d.ended(_blocks.size() - 1);}}
+
+    // ---------
+    // pop_front
+    // ---------
+
+    template <typename D>
+    void pop_front (D& d) {
+        --_size;
+        if (_size == 0)
+            clear(d);
+        else if (++_head == _columns) {
+            release(d, 0);
+            _head = 0;
+            d.ended(0);}}
+
+    // ---------
+    // push_back
+    // ---------
+
+    /**
+     * @param d the owner
+     * @param v a copy of the element, so that it can't alias one of d's
+     */
+    template <typename D, typename T>
+    void push_back (D& d, const T& v) {
+        const size_type i    = _head + _size;
+        const bool      grow = (i == _blocks.size() * _columns);
+        if (grow)
+            add(d, false);
+        try {
+            d.write(i / _columns)[i % _columns] = v;}
+        catch (...) {
+            if (grow)
+                unadd(d, false, true);
+            throw;}
+        ++_size;}
+
+    // ----------
+    // push_front
+    // ----------
+
+    /**
+     * @param d the owner
+     * @param v a copy of the element, so that it can't alias one of d's
+     */
+    template <typename D, typename T>
+    void push_front (D& d, const T& v) {
+        const bool grow = (_head == 0);
+        if (grow)
+            add(d, true);
+        const size_type h = (grow ? _columns : _head) - 1;
+        try {
+            d.write(0)[h] = v;}
+        catch (...) {
+            if (grow)
+                unadd(d, true, true);
+            throw;}
+        _head = h;
+        ++_size;}};
+
+#endif // DequeBlocks_h
@@ -0,0 +1,288 @@
+// --------------------------
+// projects/deque/DequeSort.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// --------------------------
+
+#ifndef DequeSort_h
+#define DequeSort_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // copy, lower_bound, make_heap, max, min, pop_heap, push_heap, sort, stable_sort, swap
+#include <cstddef> // size_t
+#include <exception> // current_exception, exception_ptr, rethrow_exception
+#include <functional> // less
+#include <thread> // thread
+#include <type_traits> // integral_constant, is_integral, is_same, is_signed, make_unsigned
+
+/**
+ * The fewest elements sort_runs gives a thread of its own.
+ */
+const std::size_t SORT_RUN = 4096;
+
+// --------
+// is_radix
+// --------
+
+/**
+ * True if sorting T by C can be a radix sort: T is an integer type and C is less<T>.
+ */
+template <typename T, typename C>
+struct is_radix : std::integral_constant<bool,
+    std::is_integral<T>::value && !std::is_same<T, bool>::value && std::is_same<C, std::less<T> >::value> {};
+
+// ----------
+// radix_sort
+// ----------
+
+/**
+ * @param p a pointer to n integers
+ * @param t a pointer to room for n more
+ * @param n a size_t
+ * Sorts [p, p + n) with a stable LSD radix sort, a byte per pass,
+ * skipping the bytes that are the same in every element
+ */
+template <typename T>
+void radix_sort (T* p, T* t, std::size_t n) {
+    typedef typename std::make_unsigned<T>::type U;
+    const U flip = std::is_signed<T>::value ? static_cast<U>(U(1) << (8 * sizeof(T) - 1)) : U(0);
+    T* a = p;
+    T* b = t;
+    for (unsigned k = 0; k != sizeof(T); ++k) {
+        const unsigned shift = 8 * k;
+        std::size_t count[257] = {0};
+        for (std::size_t i = 0; i != n; ++i)
+            ++count[((static_cast<U>(a[i]) ^ flip) >> shift & 0xFF) + 1];
+        bool same = false;
+        for (unsigned d = 1; d != 257; ++d)
+            if (count[d] == n)
+                same = true;
+        if (same)
+            continue;
+        for (unsigned d = 1; d != 257; ++d)
+            count[d] += count[d - 1];
+        for (std::size_t i = 0; i != n; ++i)
+            b[count[(static_cast<U>(a[i]) ^ flip) >> shift & 0xFF]++] = a[i];
+        std::swap(a, b);}
+    if (a != p)
+        std::copy(a, a + n, p);}
+
+// --------
+// sort_run
+// --------
+
+/**
+ * @param p a pointer to n elements
+ * @param t a pointer to n elements to use as scratch
+ * @param n a size_t
+ * @param c a comparator
+ * @param stable a bool
+ * Sorts one run with the tightest kernel for T and C
+ */
+template <typename T, typename C>
+void sort_run (T* p, T* t, std::size_t n, C, bool, std::true_type) {
+    radix_sort(p, t, n);}
+
+template <typename T, typename C>
+void sort_run (T* p, T*, std::size_t n, C c, bool stable, std::false_type) {
+    if (stable)
+        std::stable_sort(p, p + n, c);
+    else
+        std::sort(p, p + n, c);}
+
+// ---------
+// SortArray
+// ---------
+
+/**
+ * An array from new [] that is deleted with the scope that owns it.
+ */
+template <typename X>
+struct SortArray {
+    X* _p;
+
+    explicit SortArray (std::size_t n)
+        : _p(new X[n]) {}
+
+    ~SortArray () {
+        delete [] _p;}
+
+    X& operator [] (std::size_t i) const {
+        return _p[i];}
+
+    private:
+        SortArray (const SortArray&);
+        SortArray& operator = (const SortArray&);};
+
+// --------
+// run_jobs
+// --------
+
+/**
+ * @param f a function object, called with each j in [0, k)
+ * @param k an unsigned
+ * Calls f(j) for each j on a thread of its own, except j = 0, and any j a
+ * new thread can't be started for, which this thread runs. Joins all the
+ * threads, then rethrows the first exception any call threw.
+ */
+template <typename F>
+void run_jobs (const F& f, unsigned k) {
+    if (k == 1) {
+        f(0);
+        return;}
+
+    struct Job {
+        const F*            _f;
+        std::exception_ptr* _x;
+
+        void operator () (unsigned j) const {
+            try {
+                (*_f)(j);}
+            catch (...) {
+                _x[j] = std::current_exception();}}};
+    SortArray<std::exception_ptr> x(k);
+    const Job job = {&f, x._p};
+    {
+    SortArray<std::thread> w(k);
+    unsigned started = 1;
+    try {
+        for (; started != k; ++started)
+            w[started] = std::thread(job, started);}
+    catch (...) {}
+    job(0);
+    for (unsigned j = started; j != k; ++j)
+        job(j);
+    for (unsigned j = 1; j != started; ++j)
+        w[j].join();
+    }
+    for (unsigned j = 0; j != k; ++j)
+        if (x[j])
+            std::rethrow_exception(x[j]);}
+
+// ----------
+// merge_runs
+// ----------
+
+/**
+ * @param b an array of k pointers, the fronts of k sorted ranges, advanced as they are consumed
+ * @param e an array of k pointers, the ends of the ranges
+ * @param k a size_t
+ * @param out a pointer to room for all of them, assigned to in order
+ * @param c a comparator
+ * Merges the ranges with a heap of range indices; equal elements come
+ * out in range order, so merging stable runs is stable
+ */
+template <typename T, typename C>
+void merge_runs (T** b, T* const* e, std::size_t k, T* out, C c) {
+    struct After {
+        T** _b;
+        C   _c;
+
+        bool operator () (std::size_t i, std::size_t j) const {
+            const T& x = *_b[i];
+            const T& y = *_b[j];
+            return _c(y, x) || (!_c(x, y) && (j < i));}};
+    SortArray<std::size_t> h(k);
+    std::size_t m = 0;
+    for (std::size_t i = 0; i != k; ++i)
+        if (b[i] != e[i])
+            h[m++] = i;
+    const After after = {b, c};
+    std::make_heap(h._p, h._p + m, after);
+    while (m) {
+        std::pop_heap(h._p, h._p + m, after);
+        const std::size_t i = h[m - 1];
+        *out++ = *b[i]++;
+        if (b[i] == e[i])
+            --m;
+        else
+            std::push_heap(h._p, h._p + m, after);}}
+
+// ---------
+// sort_runs
+// ---------
+
+/**
+ * @param p a pointer to n elements
+ * @param t a pointer to n copies of them to use as scratch, or null if
+ * there is one run and it isn't a radix sort
+ * @param n a size_t
+ * @param c a comparator
+ * @param stable a bool
+ * @param threads an unsigned
+ * @return p or t, whichever holds the sorted elements
+ * Splits [p, p + n) into one run per thread, of at least SORT_RUN elements,
+ * and sorts each run on its own thread with sort_run. Then, if there is more
+ * than one run, merges them into t, again one part per thread: a sample of
+ * the runs picks splitters, and each thread merges the elements between two
+ * splitters into their place in t. The threads are run with run_jobs, so if
+ * c throws, every thread is joined before the exception leaves.
+ */
+template <typename T, typename C>
+T* sort_runs (T* p, T* t, std::size_t n, C c, bool stable, unsigned threads) {
+    const std::size_t k   = std::max<std::size_t>(1, std::min<std::size_t>(threads, n / SORT_RUN));
+    const std::size_t run = (n + k - 1) / k;
+    threads = static_cast<unsigned>(k);
+
+    struct Sorter {
+        T*          _p;
+        T*          _t;
+        std::size_t _n;
+        std::size_t _run;
+        C           _c;
+        bool        _stable;
+
+        void operator () (unsigned j) const {
+            const std::size_t o = j * _run;
+            sort_run(_p + o, _t + o, std::min(_run, _n - o), _c, _stable, is_radix<T, C>());}};
+    const Sorter sorter = {p, t, n, run, c, stable};
+    run_jobs(sorter, threads);
+    if (k == 1)
+        return p;
+
+    // bounds[j * k + i] is where the part of run i that thread j merges begins.
+    SortArray<T*> bounds((threads + 1) * k);
+    for (std::size_t i = 0; i != k; ++i) {
+        bounds[i]               = p + i * run;
+        bounds[threads * k + i] = p + std::min(n, (i + 1) * run);}
+    if (threads > 1) {
+        struct Less {
+            C _c;
+
+            bool operator () (const T* x, const T* y) const {
+                return _c(*x, *y);}};
+        const std::size_t per = 4 * threads;
+        SortArray<const T*> sample(k * per);
+        for (std::size_t i = 0; i != k; ++i)
+            for (std::size_t s = 0; s != per; ++s)
+                sample[i * per + s] = bounds[i] + (bounds[threads * k + i] - bounds[i]) * s / per;
+        const Less less = {c};
+        std::sort(sample._p, sample._p + k * per, less);
+        for (unsigned j = 1; j != threads; ++j) {
+            const T& s = *sample[k * per * j / threads];
+            for (std::size_t i = 0; i != k; ++i)
+                bounds[j * k + i] = std::lower_bound(bounds[(j - 1) * k + i], bounds[threads * k + i], s, c);}}
+
+    struct Merger {
+        T* const*   _bounds;
+        T*          _p;
+        T*          _t;
+        std::size_t _k;
+        std::size_t _run;
+        C           _c;
+
+        void operator () (unsigned j) const {
+            SortArray<T*> b(_k);
+            std::size_t o = 0;
+            for (std::size_t i = 0; i != _k; ++i) {
+                b[i] = _bounds[j * _k + i];
+                o += b[i] - (_p + i * _run);}
+            merge_runs(b._p, _bounds + (j + 1) * _k, _k, _t + o, _c);}};
+    const Merger merger = {bounds._p, p, t, k, run, c};
+    run_jobs(merger, threads);
+    return t;}
+
+#endif // DequeSort_h
@@ -0,0 +1,407 @@
+// ----------------------------
+// projects/deque/DequeStream.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// ----------------------------
+
+#ifndef DequeStream_h
+#define DequeStream_h
+
+// --------
+// includes
+// --------
+
+#include <cassert> // assert
+#include <cerrno> // errno, EINTR
+#include <cstring> // memcmp, memcpy
+#include <limits> // numeric_limits
+#include <stdexcept> // runtime_error
+#include <system_error> // system_category, system_error
+#include <type_traits> // is_trivially_copyable
+
+#include <stdint.h> // uint32_t, uint64_t
+#include <sys/stat.h> // fstat, S_ISREG
+#include <sys/uio.h> // iovec, writev
+#include <unistd.h> // lseek, pread, read
+
+#include "Deque.h"
+
+/*
+Binary format, in host byte order:
+
+    header:  char magic[8] = "MyDeque", uint32_t version, uint32_t width = sizeof(T), uint64_t count
+    payload: count elements, back to back
+
+A snapshot written by write_to() is one header and its payload.
+A stream written by MyDequeStreamWriter has count = DEQUE_STREAM_STREAMED in its header
+and is followed by any number of chunks, each a uint64_t count and its payload.
+*/
+
+// -------
+// DequeIO
+// -------
+
+/**
+ * The raw access to a deque's storage that the bulk readers and writers need.
+ */
+template <typename D>
+struct DequeIO {
+    typedef typename D::size_type     size_type;
+    typedef typename D::pointer       pointer;
+    typedef typename D::const_pointer const_pointer;
+
+    /**
+     * @param d a const deque reference
+     * @return a pointer to its one contiguous run [begin, end)
+     */
+    static const_pointer data (const D& d) {
+        return d._b;}
+
+    /**
+     * @param d a deque reference
+     * @param n a size_type
+     * @return a pointer to room for n elements past the back of d
+     */
+    static pointer extend (D& d, size_type n) {
+        return d.reserve_back(n);}
+
+    /**
+     * @param d a deque reference
+     * @param n a size_type
+     * Takes the n elements written past the back of d into d
+     */
+    static void commit (D& d, size_type n) {
+        assert((size_type)(d._back - d._e) >= n);
+        d._e += n;}};
+
+// -----------------
+// DequeStreamHeader
+// -----------------
+
+/**
+ * The header that starts a snapshot or a stream.
+ */
+struct DequeStreamHeader {
+    char     _magic[8];
+    uint32_t _version;
+    uint32_t _width;
+    uint64_t _count;};
+
+const uint32_t DEQUE_STREAM_VERSION  = 1;
+const uint64_t DEQUE_STREAM_STREAMED = ~uint64_t(0);
+
+// -------------
+// stream_header
+// -------------
+
+/**
+ * @param width a uint32_t, sizeof an element
+ * @param count a uint64_t
+ * @return a header
+ */
+inline DequeStreamHeader stream_header (uint32_t width, uint64_t count) {
+    DequeStreamHeader h;
+    std::memcpy(h._magic, "MyDeque", sizeof(h._magic));
+    h._version = DEQUE_STREAM_VERSION;
+    h._width   = width;
+    h._count   = count;
+    return h;}
+
+// ---------
+// write_all
+// ---------
+
+/**
+ * @param fd an int
+ * @param v an array of iovec, consumed as it is written
+ * @param n an int, the length of v
+ * Calls writev until every buffer is written, throws system_error on failure
+ */
+inline void write_all (int fd, iovec* v, int n) {
+    while (n != 0) {
+        const ssize_t w = ::writev(fd, v, n);
+        if (w == -1) {
+            if (errno == EINTR)
+                continue;
+            throw std::system_error(errno, std::system_category(), "writev");}
+        size_t r = w;
+        while ((n != 0) && (r >= v->iov_len)) {
+            r -= v->iov_len;
+            ++v;
+            --n;}
+        if (n != 0) {
+            v->iov_base = static_cast<char*>(v->iov_base) + r;
+            v->iov_len -= r;}}}
+
+// --------
+// read_all
+// --------
+
+/**
+ * @param fd an int
+ * @param p a void pointer
+ * @param n a size_t
+ * @return the number of bytes read, less than n only at end of file
+ */
+inline size_t read_all (int fd, void* p, size_t n) {
+    size_t t = 0;
+    while (t != n) {
+        const ssize_t r = ::read(fd, static_cast<char*>(p) + t, n - t);
+        if (r == -1) {
+            if (errno == EINTR)
+                continue;
+            throw std::system_error(errno, std::system_category(), "read");}
+        if (r == 0)
+            break;
+        t += r;}
+    return t;}
+
+// ---------
+// pread_all
+// ---------
+
+/**
+ * @param fd an int
+ * @param p a void pointer
+ * @param n a size_t
+ * @param o an off_t, where in fd to read from
+ * @return the number of bytes read, less than n only at end of file
+ * Leaves the file position of fd alone
+ */
+inline size_t pread_all (int fd, void* p, size_t n, off_t o) {
+    size_t t = 0;
+    while (t != n) {
+        const ssize_t r = ::pread(fd, static_cast<char*>(p) + t, n - t, o + t);
+        if (r == -1) {
+            if (errno == EINTR)
+                continue;
+            throw std::system_error(errno, std::system_category(), "pread");}
+        if (r == 0)
+            break;
+        t += r;}
+    return t;}
+
+// ---------
+// remaining
+// ---------
+
+/**
+ * @param fd an int
+ * @param o an off_t, a position in fd
+ * @return the number of bytes in fd past o, or -1 if fd isn't a regular file
+ */
+inline int64_t remaining (int fd, off_t o) {
+    struct stat s;
+    if ((::fstat(fd, &s) == -1) || !S_ISREG(s.st_mode))
+        return -1;
+    return (s.st_size > o) ? s.st_size - o : 0;}
+
+// ----------
+// fits_block
+// ----------
+
+/**
+ * @param n a uint64_t, a count of elements
+ * @param width a size_t, sizeof an element
+ * @param r an int64_t, the bytes left in the file, or -1 if unknown
+ * @return true if n elements can be in memory and, if r is known, in the file
+ */
+inline bool fits_block (uint64_t n, size_t width, int64_t r) {
+    if (n > std::numeric_limits<size_t>::max() / width)
+        return false;
+    return (r == -1) || (n <= static_cast<uint64_t>(r) / width);}
+
+// -----------
+// read_header
+// -----------
+
+/**
+ * @param fd an int
+ * @param width a uint32_t, the expected sizeof an element
+ * @return the count in the header
+ * Throws runtime_error if the header is missing, of another version, or of another element size
+ */
+inline uint64_t read_header (int fd, uint32_t width) {
+    DequeStreamHeader h;
+    if (read_all(fd, &h, sizeof(h)) != sizeof(h))
+        throw std::runtime_error("DequeStream: truncated header");
+    if (std::memcmp(h._magic, "MyDeque", sizeof(h._magic)) || (h._version != DEQUE_STREAM_VERSION))
+        throw std::runtime_error("DequeStream: not a deque stream of this version");
+    if (h._width != width)
+        throw std::runtime_error("DequeStream: element size mismatch");
+    return h._count;}
+
+// ----------
+// read_block
+// ----------
+
+/**
+ * @param fd an int
+ * @param d a MyDeque reference
+ * @param n a uint64_t, the number of elements to read
+ * Appends n elements read straight into the storage of d. Throws
+ * runtime_error, before allocating, if fd is a file with fewer than n left.
+ */
+template <typename T, typename A>
+void read_block (int fd, MyDeque<T, A>& d, uint64_t n) {
+    typedef DequeIO< MyDeque<T, A> > IO;
+    if (n == 0)
+        return;
+    const off_t o = ::lseek(fd, 0, SEEK_CUR);
+    if (!fits_block(n, sizeof(T), (o == -1) ? -1 : remaining(fd, o)))
+        throw std::runtime_error("DequeStream: truncated payload");
+    T* p = IO::extend(d, n);
+    if (read_all(fd, p, n * sizeof(T)) != n * sizeof(T))
+        throw std::runtime_error("DequeStream: truncated payload");
+    IO::commit(d, n);}
+
+// --------
+// write_to
+// --------
+
+/**
+ * @param fd an int
+ * @param d a const MyDeque reference
+ * Writes a snapshot of d: the header and every storage run in one writev
+ */
+template <typename T, typename A>
+void write_to (int fd, const MyDeque<T, A>& d) {
+    static_assert(std::is_trivially_copyable<T>::value, "write_to requires a trivially copyable T");
+    typedef DequeIO< MyDeque<T, A> > IO;
+    DequeStreamHeader h = stream_header(sizeof(T), d.size());
+    iovec v[2];
+    v[0].iov_base = &h;
+    v[0].iov_len  = sizeof(h);
+    v[1].iov_base = const_cast<T*>(IO::data(d));
+    v[1].iov_len  = d.size() * sizeof(T);
+    write_all(fd, v, d.empty() ? 1 : 2);}
+
+// ---------
+// read_from
+// ---------
+
+/**
+ * @param fd an int
+ * @param d a MyDeque reference
+ * Replaces the contents of d with a snapshot or a whole stream read from fd.
+ * The payload is read into d's storage with no per-element construction.
+ */
+template <typename T, typename A>
+void read_from (int fd, MyDeque<T, A>& d) {
+    static_assert(std::is_trivially_copyable<T>::value, "read_from requires a trivially copyable T");
+    const uint64_t n = read_header(fd, sizeof(T));
+    d.clear();
+    if (n != DEQUE_STREAM_STREAMED) {
+        read_block(fd, d, n);
+        return;}
+    uint64_t c;
+    while (read_all(fd, &c, sizeof(c)) == sizeof(c))
+        read_block(fd, d, c);}
+
+// -------------------
+// MyDequeStreamWriter
+// -------------------
+
+/**
+ * Appends chunks of elements to a stream, for log-style persistence.
+ * The stream header is written on construction; every append() is one writev.
+ */
+template <typename T>
+class MyDequeStreamWriter {
+    static_assert(std::is_trivially_copyable<T>::value, "MyDequeStreamWriter requires a trivially copyable T");
+
+    private:
+        int _fd;
+
+    public:
+        /**
+         * @param fd an int, positioned where the stream starts
+         */
+        explicit MyDequeStreamWriter (int fd)
+            : _fd(fd) {
+            DequeStreamHeader h = stream_header(sizeof(T), DEQUE_STREAM_STREAMED);
+            iovec v[1];
+            v[0].iov_base = &h;
+            v[0].iov_len  = sizeof(h);
+            write_all(_fd, v, 1);}
+
+        /**
+         * @param p a const T pointer
+         * @param n a size_t
+         * Appends the chunk [p, p + n)
+         */
+        void append (const T* p, size_t n) {
+            if (n == 0)
+                return;
+            uint64_t c = n;
+            iovec v[2];
+            v[0].iov_base = &c;
+            v[0].iov_len  = sizeof(c);
+            v[1].iov_base = const_cast<T*>(p);
+            v[1].iov_len  = n * sizeof(T);
+            write_all(_fd, v, 2);}
+
+        /**
+         * @param d a const MyDeque reference
+         * Appends the contents of d as one chunk
+         */
+        template <typename A>
+        void append (const MyDeque<T, A>& d) {
+            append(DequeIO< MyDeque<T, A> >::data(d), d.size());}};
+
+// -------------------
+// MyDequeStreamReader
+// -------------------
+
+/**
+ * Reads a stream chunk by chunk, for tailing a log as it is appended.
+ * The reader keeps its own offset and reads with pread, so a chunk that is
+ * only partly written yet is left for a later call to read whole.
+ */
+template <typename T>
+class MyDequeStreamReader {
+    static_assert(std::is_trivially_copyable<T>::value, "MyDequeStreamReader requires a trivially copyable T");
+
+    private:
+        int   _fd;
+        off_t _offset; // where the next chunk starts
+
+    public:
+        /**
+         * @param fd an int, a seekable file positioned at the start of a stream
+         * Throws runtime_error if fd doesn't hold a stream of T
+         */
+        explicit MyDequeStreamReader (int fd)
+            : _fd(fd), _offset(0) {
+            if (read_header(_fd, sizeof(T)) != DEQUE_STREAM_STREAMED)
+                throw std::runtime_error("DequeStream: a snapshot, not a stream");
+            _offset = ::lseek(_fd, 0, SEEK_CUR);
+            if (_offset == -1)
+                throw std::system_error(errno, std::system_category(), "lseek");}
+
+        /**
+         * @param d a MyDeque reference
+         * @return the number of elements appended to d, 0 at the end of the stream
+         * Appends the next chunk to d if all of it has been written,
+         * and otherwise appends nothing and consumes nothing
+         */
+        template <typename A>
+        size_t next (MyDeque<T, A>& d) {
+            typedef DequeIO< MyDeque<T, A> > IO;
+            uint64_t c;
+            do {
+                if (pread_all(_fd, &c, sizeof(c), _offset) != sizeof(c))
+                    return 0;
+                if (!fits_block(c, sizeof(T), remaining(_fd, _offset + sizeof(c))))
+                    return 0;
+                if (c == 0)
+                    _offset += sizeof(c);}
+            while (c == 0);
+            T* p = IO::extend(d, c);
+            if (pread_all(_fd, p, c * sizeof(T), _offset + sizeof(c)) != c * sizeof(T))
+                return 0;
+            IO::commit(d, c);
+            _offset += sizeof(c) + c * sizeof(T);
+            return c;}};
+
+#endif // DequeStream_h
@@ -0,0 +1,282 @@
+// ----------------------------------
+// projects/deque/HugePageAllocator.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// ----------------------------------
+
+#ifndef HugePageAllocator_h
+#define HugePageAllocator_h
+
+// --------
+// includes
+// --------
+
+#include <cstddef> // ptrdiff_t, size_t
+#include <limits> // numeric_limits
+#include <new> // bad_alloc, operator new, operator delete
+
+#include <stdint.h> // uintptr_t
+#include <sys/mman.h> // madvise, mmap, munmap, MADV_HUGEPAGE, MAP_HUGETLB
+#include <sys/syscall.h> // SYS_getcpu, SYS_mbind
+#include <unistd.h> // syscall
+
+/**
+ * The bytes in a huge page, and the smallest request MyHugePageAllocator maps directly.
+ */
+const std::size_t HUGE_PAGE = 2 << 20;
+
+// -------------------
+// MyHugePageAllocator
+// -------------------
+
+/**
+ * An allocator for large deque storage on Linux.
+ * Requests of at least HUGE_PAGE bytes are mapped directly, rounded up to
+ * a whole number of huge pages:
+ *   HUGE_TLB     tries an explicit hugetlb mapping first, which needs pages
+ *                reserved in /proc/sys/vm/nr_hugepages;
+ *   HUGE_MADVISE otherwise maps a huge-page-aligned region and asks for
+ *                transparent huge pages with MADV_HUGEPAGE;
+ *   HUGE_NUMA    binds the region to the NUMA node of the calling thread
+ *                with a preferred mbind, so it stays there even if another
+ *                thread touches it first.
+ * Each step that the kernel refuses is skipped, so the worst case is an
+ * ordinary anonymous mapping. Smaller requests use operator new.
+ * How a block was obtained depends only on its size, so every instance can
+ * free what any other instance allocated and all instances compare equal.
+ */
+template <typename T>
+class MyHugePageAllocator {
+    public:
+    // --------
+    // typedefs
+    // --------
+
+    typedef T           value_type;
+
+    typedef std::size_t    size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    typedef T*          pointer;
+    typedef const T*    const_pointer;
+
+    typedef T&          reference;
+    typedef const T&    const_reference;
+
+    template <typename U>
+    struct rebind {
+        typedef MyHugePageAllocator<U> other;};
+
+    // -----
+    // flags
+    // -----
+
+    enum {
+        HUGE_TLB     = 1,
+        HUGE_MADVISE = 2,
+        HUGE_NUMA    = 4};
+
+    public:
+    // -----------
+    // operator ==
+    // -----------
+
+    /**
+     * @return true, any instance can free what another allocated
+     */
+    friend bool operator == (const MyHugePageAllocator&, const MyHugePageAllocator&) {
+        return true;}
+
+    /**
+     * @return false
+     */
+    friend bool operator != (const MyHugePageAllocator&, const MyHugePageAllocator&) {
+        return false;}
+
+private:
+    // ----
+    // data
+    // ----
+
+    unsigned _flags;
+
+    private:
+        // ------
+        // length
+        // ------
+
+        /**
+         * @param n a size_type, a number of elements
+         * @return the bytes to map for n elements, or 0 if they come from operator new
+         */
+        static size_type length (size_type n) {
+            const size_type s = n * sizeof(T);
+            if (s < HUGE_PAGE)
+                return 0;
+            return (s + HUGE_PAGE - 1) / HUGE_PAGE * HUGE_PAGE;}
+
+        // ---
+        // map
+        // ---
+
+        /**
+         * @param s a size_type, a multiple of HUGE_PAGE
+         * @return a HUGE_PAGE-aligned mapping of s bytes
+         */
+        void* map (size_type s) const {
+#ifdef MAP_HUGETLB
+            if (_flags & HUGE_TLB) {
+                void* p = ::mmap(0, s, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+                if (p != MAP_FAILED)
+                    return p;}
+#endif
+            // Over-map by one huge page and trim both sides to get alignment.
+            char* q = static_cast<char*>(::mmap(0, s + HUGE_PAGE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+            if (q == MAP_FAILED)
+                throw std::bad_alloc();
+            char* p = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(q) + HUGE_PAGE - 1) / HUGE_PAGE * HUGE_PAGE);
+            if (p != q)
+                ::munmap(q, p - q);
+            if (p + s != q + s + HUGE_PAGE)
+                ::munmap(p + s, (q + s + HUGE_PAGE) - (p + s));
+#ifdef MADV_HUGEPAGE
+            if (_flags & HUGE_MADVISE)
+                ::madvise(p, s, MADV_HUGEPAGE);
+#endif
+            return p;}
+
+        // -----
+        // place
+        // -----
+
+        /**
+         * @param p a void pointer to a mapping not touched yet
+         * @param s a size_type
+         * Prefers the calling thread's node for p; does nothing where NUMA isn't available
+         */
+        static void place (void* p, size_type s) {
+#if defined(SYS_getcpu) && defined(SYS_mbind)
+            unsigned cpu  = 0;
+            unsigned node = 0;
+            if (::syscall(SYS_getcpu, &cpu, &node, 0) != 0)
+                return;
+            const unsigned bits = std::numeric_limits<unsigned long>::digits;
+            if (node >= 16 * bits)
+                return;
+            unsigned long mask[16] = {0};
+            mask[node / bits] = 1UL << (node % bits);
+            const int preferred = 1; // MPOL_PREFERRED
+            ::syscall(SYS_mbind, p, s, preferred, mask, 16 * bits + 1, 0);
+#else
+            (void)p;
+            (void)s;
+#endif
+            }
+
+    public:
+        // ------------
+        // constructors
+        // ------------
+
+        /**
+         * @param flags an unsigned, any of HUGE_TLB, HUGE_MADVISE, HUGE_NUMA
+         */
+        MyHugePageAllocator (unsigned flags = HUGE_TLB | HUGE_MADVISE | HUGE_NUMA)
+            : _flags(flags) {}
+
+        /**
+         * @param that an allocator for another type
+         * Rebinding copy constructor
+         */
+        template <typename U>
+        MyHugePageAllocator (const MyHugePageAllocator<U>& that)
+            : _flags(that.flags()) {}
+
+        // Default copy, destructor, and copy assignment.
+
+        // -----
+        // flags
+        // -----
+
+        /**
+         * @return an unsigned
+         */
+        unsigned flags () const {
+            return _flags;}
+
+        // --------
+        // allocate
+        // --------
+
+        /**
+         * @param n a size_type
+         * @return a pointer to room for n elements, not constructed
+         */
+        pointer allocate (size_type n, const void* = 0) {
+            if (n > max_size())
+                throw std::bad_alloc();
+            const size_type s = length(n);
+            if (s == 0)
+                return static_cast<pointer>(::operator new(n * sizeof(T)));
+            void* p = map(s);
+            if (_flags & HUGE_NUMA)
+                place(p, s);
+            return static_cast<pointer>(p);}
+
+        // ----------
+        // deallocate
+        // ----------
+
+        /**
+         * @param p a pointer from allocate(n)
+         * @param n a size_type
+         */
+        void deallocate (pointer p, size_type n) {
+            const size_type s = length(n);
+            if (s == 0)
+                ::operator delete(p);
+            else
+                ::munmap(p, s);}
+
+        // ---------
+        // construct
+        // ---------
+
+        /**
+         * @param p a pointer
+         * @param v a const_reference
+         */
+        void construct (pointer p, const_reference v) {
+            new (static_cast<void*>(p)) T(v);}
+
+        // -------
+        // destroy
+        // -------
+
+        /**
+         * @param p a pointer
+         */
+        void destroy (pointer p) {
+            p->~T();}
+
+        // --------
+        // max_size
+        // --------
+
+        /**
+         * @return a size_type
+         */
+        size_type max_size () const {
+            return std::numeric_limits<size_type>::max() / sizeof(T);}
+
+        // -------
+        // address
+        // -------
+
+        pointer address (reference r) const {
+            return &r;}
+
+        const_pointer address (const_reference r) const {
+            return &r;}};
+
+#endif // HugePageAllocator_h
@@ -0,0 +1,1410 @@
+// -----------------------------
+// projects/deque/IndexedDeque.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// -----------------------------
+
+#ifndef IndexedDeque_h
+#define IndexedDeque_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // copy, copy_backward, equal, lexicographical_compare, max, min, swap
+#include <cassert> // assert
+#include <cstddef> // size_t
+#include <iterator> // random_access_iterator_tag
+#include <memory> // allocator, allocator_traits
+#include <stdexcept> // out_of_range
+
+#include "Deque.h" // COLUMNS, destroy, uninitialized_copy
+
+/**
+ * The most children an interior node of a MyIndexedDeque has.
+ */
+const std::size_t FANOUT = 32;
+
+// --------------
+// MyIndexedDeque
+// --------------
+
+/**
+ * A deque whose blocks of COLUMNS elements are the leaves of a counted B-tree.
+ * Every interior node records the number of elements below each child, so
+ * indexing, insert and erase at any position walk a single root-to-leaf path
+ * and cost O(log n); an insert or erase shifts at most one block.
+ * The first and last leaves are cached, and each leaf keeps a gap in front
+ * of its elements, so a push or pop at either end only touches its leaf
+ * until the leaf fills or empties. The counts on the leftmost and rightmost
+ * paths are brought up to date lazily, before anything walks down the tree.
+ */
+template < typename T, typename A = std::allocator<T> >
+class MyIndexedDeque {
+    public:
+    // --------
+    // typedefs
+    // --------
+
+    typedef A   allocator_type;
+    typedef std::allocator_traits<allocator_type>   allocator_traits_type;
+    typedef typename allocator_traits_type::value_type value_type; // T
+
+    typedef typename allocator_traits_type::size_type  size_type;
+    typedef typename allocator_traits_type::difference_type    difference_type;
+
+    typedef typename allocator_traits_type::pointer    pointer;    // T*
+    typedef typename allocator_traits_type::const_pointer  const_pointer;
+
+    typedef value_type&  reference;
+    typedef const value_type&    const_reference;
+
+public:
+    // -----------
+    // operator ==
+    // -----------
+
+    /**
+     * @param lhs a const MyIndexedDeque reference
+     * @param rhs a const MyIndexedDeque reference
+     * @return a true if equal or false if not
+     * Checks if lhs equals rhs
+     * (lhs == rhs) => true or false)
+     */
+    friend bool operator == (const MyIndexedDeque& lhs, const MyIndexedDeque& rhs) {
+        return (lhs.size() == rhs.size()) && (equal(lhs.begin(), lhs.end(), rhs.begin()));}
+
+    // ----------
+    // operator <
+    // ----------
+
+    /**
+     * @param lhs a const MyIndexedDeque reference
+     * @param rhs a const MyIndexedDeque reference
+     * @return a true if less than or false if greater or equal
+     * Checks if lhs is less than rhs
+     * (lhs < rhs) => true or false)
+     */
+    friend bool operator < (const MyIndexedDeque& lhs, const MyIndexedDeque& rhs) {
+        return lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());}
+
+private:
+    // ----
+    // Node
+    // ----
+
+    /**
+     * A leaf owns a block of COLUMNS elements, [_gap, _gap + _n) of them constructed.
+     * An interior node owns _n children; _size counts the elements below it.
+     */
+    struct Node {
+        bool      _leaf;
+        size_type _n;
+        size_type _size;
+        size_type _gap;
+        pointer   _data;
+        Node*     _child[FANOUT];};
+
+    typedef typename allocator_traits_type::template rebind_alloc<Node> allocatorNode_type;
+
+private:
+    // ----
+    // data
+    // ----
+
+    allocator_type _a;
+    allocatorNode_type _aNode;
+
+    Node* _root;
+
+    // The end leaves, and the pushes less pops at each end that the
+    // interior nodes on the leftmost and rightmost paths don't count yet.
+    Node*           _first;
+    Node*           _last;
+    difference_type _front;
+    difference_type _back;
+
+    // Nodes allocated ahead of an insert, linked through _child[0].
+    Node* _spare;
+
+    private:
+        // -----
+        // valid
+        // -----
+
+        bool valid () const {
+            return !_root || _root->_leaf || (_root->_n > 1);}
+
+        // --------
+        // capacity
+        // --------
+
+        static size_type capacity (const Node* x) {
+            return x->_leaf ? COLUMNS : FANOUT;}
+
+        // ----
+        // make
+        // ----
+
+        /**
+         * @param leaf a bool
+         * @return a pointer to an empty Node
+         */
+        Node* make (bool leaf) {
+            Node* x = _aNode.allocate(1);
+            x->_leaf = leaf;
+            x->_n    = 0;
+            x->_size = 0;
+            x->_gap  = 0;
+            x->_data = 0;
+            if (leaf) {
+                try {
+                    x->_data = _a.allocate(COLUMNS);}
+                catch (...) {
+                    _aNode.deallocate(x, 1);
+                    throw;}}
+            return x;}
+
+        // ----
+        // free
+        // ----
+
+        /**
+         * @param x a pointer to a Node whose elements have been destroyed or moved
+         */
+        void free (Node* x) {
+            if (x->_leaf)
+                _a.deallocate(x->_data, COLUMNS);
+            _aNode.deallocate(x, 1);}
+
+        /**
+         * @param x a pointer to a Node
+         * Destroys every element below x and frees the subtree
+         */
+        void release (Node* x) {
+            if (x->_leaf)
+                destroy(_a, x->_data + x->_gap, x->_data + x->_gap + x->_n);
+            else
+                for (size_type k = 0; k != x->_n; ++k)
+                    release(x->_child[k]);
+            free(x);}
+
+        // ------
+        // locate
+        // ------
+
+        /**
+         * @param i a size_type reference, an index on entry and an offset into the leaf on return
+         * @return a pointer to the leaf holding element i
+         * The last child is never counted, only stepped into, so the
+         * pending pushes and pops at the back never enter the search.
+         */
+        Node* locate (size_type& i) const {
+            Node* x = _root;
+            bool  l = true;
+            while (!x->_leaf) {
+                size_type k = 0;
+                for (; k + 1 != x->_n; ++k) {
+                    const size_type s = count(x->_child[k], l && (k == 0), false);
+                    if (i < s)
+                        break;
+                    i -= s;}
+                l = l && (k == 0);
+                x = x->_child[k];}
+            return x;}
+
+        // -----
+        // count
+        // -----
+
+        /**
+         * @param x a pointer to a Node
+         * @param l a bool, true if x is on the leftmost path
+         * @param r a bool, true if x is on the rightmost path
+         * @return the number of elements below x, including the pushes and
+         * pops at the ends that x doesn't count yet
+         */
+        size_type count (const Node* x, bool l, bool r) const {
+            if (x->_leaf)
+                return x->_size;
+            return x->_size + (l ? _front : 0) + (r ? _back : 0);}
+
+        // ----
+        // sync
+        // ----
+
+        /**
+         * Adds the pending pushes and pops at the ends to the interior nodes
+         * on the leftmost and rightmost paths
+         */
+        void sync () {
+            if (_root)
+                for (Node* x = _root; !x->_leaf; x = x->_child[0])
+                    x->_size += _front;
+            if (_root)
+                for (Node* x = _root; !x->_leaf; x = x->_child[x->_n - 1])
+                    x->_size += _back;
+            _front = _back = 0;}
+
+        // -----
+        // cache
+        // -----
+
+        /**
+         * Finds the first and last leaves again after the tree changes shape
+         */
+        void cache () {
+            _first = _last = _root;
+            if (!_root)
+                return;
+            while (!_first->_leaf)
+                _first = _first->_child[0];
+            while (!_last->_leaf)
+                _last = _last->_child[_last->_n - 1];}
+
+        // -----
+        // slide
+        // -----
+
+        /**
+         * @param x a pointer to a leaf
+         * @param g a size_type, with g + x->_n <= COLUMNS
+         * Moves the elements of x so that g slots are free in front of them
+         */
+        void slide (Node* x, size_type g) {
+            const pointer   p = x->_data;
+            const size_type n = x->_n;
+            const size_type h = x->_gap;
+            if (g < h) {
+                for (size_type j = 0; j != n; ++j) {
+                    if (g + j < h)
+                        allocator_traits_type::construct(_a, p + g + j, p[h + j]);
+                    else
+                        p[g + j] = p[h + j];}
+                destroy(_a, p + std::max(g + n, h), p + h + n);}
+            else if (g > h) {
+                for (size_type j = n; j != 0; --j) {
+                    if (g + j - 1 >= h + n)
+                        allocator_traits_type::construct(_a, p + g + j - 1, p[h + j - 1]);
+                    else
+                        p[g + j - 1] = p[h + j - 1];}
+                destroy(_a, p + h, p + std::min(g, h + n));}
+            x->_gap = g;}
+
+        // -------
+        // reserve
+        // -------
+
+        /**
+         * @param i a size_type, a position in [0, size()]
+         * Allocates the nodes that inserting at i splits off, and a new root
+         * if the root splits, so that nothing can fail to allocate once
+         * elements start to move; frees them all if one allocation fails
+         */
+        void reserve (size_type i) {
+            size_type full  = 0;
+            size_type depth = 0;
+            for (Node* x = _root; ; ) {
+                ++depth;
+                full = (x->_n == capacity(x)) ? full + 1 : 0;
+                if (x->_leaf)
+                    break;
+                size_type k = 0;
+                while ((k + 1 != x->_n) && (i > x->_child[k]->_size)) {
+                    i -= x->_child[k]->_size;
+                    ++k;}
+                x = x->_child[k];}
+            // The leaf and the full nodes above it in a row split.
+            try {
+                for (size_type j = 0; j != full + (full == depth); ++j) {
+                    Node* y = make(j == 0);
+                    y->_child[0] = _spare;
+                    _spare = y;}}
+            catch (...) {
+                unreserve();
+                throw;}}
+
+        /**
+         * Frees the nodes reserve allocated that weren't used
+         */
+        void unreserve () {
+            while (_spare) {
+                Node* y = _spare;
+                _spare = y->_child[0];
+                free(y);}}
+
+        /**
+         * @param leaf a bool
+         * @return a node that reserve allocated
+         */
+        Node* take (bool leaf) {
+            Node** p = &_spare;
+            while ((*p)->_leaf != leaf)
+                p = &(*p)->_child[0];
+            Node* x = *p;
+            *p = x->_child[0];
+            return x;}
+
+        // -----
+        // shift
+        // -----
+
+        /**
+         * @param p a pointer to a block with n constructed elements
+         * @param n a size_type
+         * @param m a size_type
+         * Moves [p, p + n) to [p + m, p + n + m), leaving [p, p + min(n, m)) constructed
+         */
+        void shift (pointer p, size_type n, size_type m) {
+            for (size_type j = n; j != 0; --j) {
+                if (j - 1 + m >= n)
+                    allocator_traits_type::construct(_a, p + j - 1 + m, p[j - 1]);
+                else
+                    p[j - 1 + m] = p[j - 1];}}
+
+        // ----
+        // move
+        // ----
+
+        /**
+         * @param l a pointer to a Node
+         * @param r a pointer to its right sibling
+         * @param m a size_type
+         * Moves the first m entries of r to the end of l
+         */
+        void move_left (Node* l, Node* r, size_type m) {
+            if (m == 0)
+                return;
+            if (l->_leaf) {
+                slide(l, 0);
+                slide(r, 0);
+                uninitialized_copy(_a, r->_data, r->_data + m, l->_data + l->_n);
+                copy(r->_data + m, r->_data + r->_n, r->_data);
+                destroy(_a, r->_data + r->_n - m, r->_data + r->_n);
+                l->_size += m;
+                r->_size -= m;}
+            else {
+                size_type s = 0;
+                for (size_type k = 0; k != m; ++k) {
+                    s += r->_child[k]->_size;
+                    l->_child[l->_n + k] = r->_child[k];}
+                copy(r->_child + m, r->_child + r->_n, r->_child);
+                l->_size += s;
+                r->_size -= s;}
+            l->_n += m;
+            r->_n -= m;}
+
+        /**
+         * @param l a pointer to a Node
+         * @param r a pointer to its right sibling
+         * @param m a size_type
+         * Moves the last m entries of l to the front of r
+         */
+        void move_right (Node* l, Node* r, size_type m) {
+            if (m == 0)
+                return;
+            if (l->_leaf) {
+                slide(l, 0);
+                slide(r, 0);
+                shift(r->_data, r->_n, m);
+                for (size_type j = 0; j != m; ++j) {
+                    if (j < r->_n)
+                        r->_data[j] = l->_data[l->_n - m + j];
+                    else
+                        allocator_traits_type::construct(_a, r->_data + j, l->_data[l->_n - m + j]);}
+                destroy(_a, l->_data + l->_n - m, l->_data + l->_n);
+                l->_size -= m;
+                r->_size += m;}
+            else {
+                size_type s = 0;
+                copy_backward(r->_child, r->_child + r->_n, r->_child + r->_n + m);
+                for (size_type k = 0; k != m; ++k) {
+                    s += l->_child[l->_n - m + k]->_size;
+                    r->_child[k] = l->_child[l->_n - m + k];}
+                l->_size -= s;
+                r->_size += s;}
+            l->_n -= m;
+            r->_n += m;}
+
+        // -----
+        // split
+        // -----
+
+        /**
+         * @param x a pointer to a full Node
+         * @param at a size_type
+         * @return a pointer to a new right sibling holding the entries of x past at,
+         * taken from the nodes that reserve allocated
+         */
+        Node* split (Node* x, size_type at) {
+            Node* y = take(x->_leaf);
+            move_right(x, y, x->_n - at);
+            return y;}
+
+        // ---------
+        // add_child
+        // ---------
+
+        /**
+         * @param x a pointer to an interior Node with room for one more child
+         * @param k a size_type
+         * @param y a pointer to a Node
+         * Makes y the k-th child of x without touching x->_size
+         */
+        static void add_child (Node* x, size_type k, Node* y) {
+            copy_backward(x->_child + k, x->_child + x->_n, x->_child + x->_n + 1);
+            x->_child[k] = y;
+            ++x->_n;}
+
+        // ------
+        // insert
+        // ------
+
+        /**
+         * @param x a pointer to a Node
+         * @param i a size_type, a position in [0, x->_size]
+         * @param v a const_reference, not an element of this deque
+         * @return a pointer to a new right sibling of x if x had to split, or 0
+         */
+        Node* insert (Node* x, size_type i, const_reference v) {
+            if (x->_leaf) {
+                slide(x, 0);
+                if (x->_n != COLUMNS) {
+                    if (i == x->_n)
+                        allocator_traits_type::construct(_a, x->_data + i, v);
+                    else {
+                        shift(x->_data + i, x->_n - i, 1);
+                        x->_data[i] = v;}
+                    ++x->_n;
+                    ++x->_size;
+                    return 0;}
+                // A full block splits at the insertion point when that is
+                // one of its ends, so growth at either end packs blocks full.
+                const size_type at = ((i == 0) || (i == COLUMNS)) ? i : COLUMNS / 2;
+                Node* y = split(x, at);
+                if ((i < at) || ((i == at) && (at != COLUMNS)))
+                    insert(x, i, v);
+                else
+                    insert(y, i - at, v);
+                return y;}
+
+            size_type k = 0;
+            while ((k + 1 != x->_n) && (i > x->_child[k]->_size)) {
+                i -= x->_child[k]->_size;
+                ++k;}
+            Node* y = insert(x->_child[k], i, v);
+            ++x->_size;
+            if (!y)
+                return 0;
+            if (x->_n != FANOUT) {
+                add_child(x, k + 1, y);
+                return 0;}
+            const size_type at = (k + 1 == FANOUT) ? FANOUT : FANOUT / 2;
+            Node* z = split(x, at);
+            if (at == FANOUT)
+                add_child(z, 0, y);
+            else if (k + 1 <= at)
+                add_child(x, k + 1, y);
+            else
+                add_child(z, k + 1 - at, y);
+            // y's elements were counted in x, the parent of the node it split from
+            if ((at == FANOUT) || (k + 1 > at)) {
+                x->_size -= y->_size;
+                z->_size += y->_size;}
+            return z;}
+
+        // -----
+        // erase
+        // -----
+
+        /**
+         * @param x a pointer to a Node
+         * @param i a size_type, a position in [0, x->_size)
+         * A child that this empties is freed, so no leaf is ever left empty
+         * except a leaf at the root
+         */
+        void erase (Node* x, size_type i) {
+            --x->_size;
+            if (x->_leaf) {
+                slide(x, 0);
+                copy(x->_data + i + 1, x->_data + x->_n, x->_data + i);
+                --x->_n;
+                allocator_traits_type::destroy(_a, x->_data + x->_n);
+                return;}
+            size_type k = 0;
+            while (i >= x->_child[k]->_size) {
+                i -= x->_child[k]->_size;
+                ++k;}
+            erase(x->_child[k], i);
+            if (x->_child[k]->_size == 0) {
+                release(x->_child[k]);
+                copy(x->_child + k + 1, x->_child + x->_n, x->_child + k);
+                --x->_n;}
+            else
+                rebalance(x, k);}
+
+        // ---------
+        // rebalance
+        // ---------
+
+        /**
+         * @param x a pointer to an interior Node
+         * @param k a size_type
+         * Merges or evens out the k-th child of x with a sibling once it falls below a quarter full
+         */
+        void rebalance (Node* x, size_type k) {
+            Node* c = x->_child[k];
+            if ((x->_n == 1) || (c->_n >= capacity(c) / 4))
+                return;
+            const size_type j = (k + 1 != x->_n) ? k + 1 : k - 1;
+            Node* l = x->_child[std::min(j, k)];
+            Node* r = x->_child[std::max(j, k)];
+            if (l->_n + r->_n <= capacity(l)) {
+                move_left(l, r, r->_n);
+                free(r);
+                copy(x->_child + std::max(j, k) + 1, x->_child + x->_n, x->_child + std::max(j, k));
+                --x->_n;}
+            else {
+                const size_type half = (l->_n + r->_n) / 2;
+                if (l->_n < half)
+                    move_left(l, r, half - l->_n);
+                else
+                    move_right(l, r, l->_n - half);}}
+
+    public:
+        // --------
+        // iterator
+        // --------
+
+        class iterator {
+            public:
+                // --------
+                // typedefs
+                // --------
+
+                typedef std::random_access_iterator_tag      iterator_category;
+                typedef typename MyIndexedDeque::value_type      value_type;
+                typedef typename MyIndexedDeque::difference_type difference_type;
+                typedef typename MyIndexedDeque::pointer         pointer;
+                typedef typename MyIndexedDeque::reference       reference;
+                typedef typename MyIndexedDeque::size_type       size_type;
+
+            public:
+                // -----------
+                // operator ==
+                // -----------
+
+                /**
+                 * @param lhs a const iterator reference
+                 * @param rhs a const iterator reference
+                 * @return a true if equal or false if not
+                 * (lhs == rhs) => true or false
+                 */
+                friend bool operator == (const iterator& lhs, const iterator& rhs) {
+                    return (lhs._deque == rhs._deque) && (lhs._idx == rhs._idx);}
+
+                /**
+                 * @param lhs a const iterator reference
+                 * @param rhs a const iterator reference
+                 * @return a false if equal or true if not
+                 * (lhs != rhs) => true or false
+                 */
+                friend bool operator != (const iterator& lhs, const iterator& rhs) {
+                    return !(lhs == rhs);}
+
+                // ----------
+                // operator <
+                // ----------
+
+                /**
+                 * @param lhs a const iterator reference
+                 * @param rhs a const iterator reference
+                 * @return a true if lhs comes before rhs
+                 */
+                friend bool operator < (const iterator& lhs, const iterator& rhs) {
+                    return lhs._idx < rhs._idx;}
+
+                // ----------
+                // operator +
+                // ----------
+
+                /**
+                 * @param lhs an iterator
+                 * @param rhs a difference_type which is the amount being added.
+                 * @return an iterator
+                 * (lhs + rhs) => iterator
+                 */
+                friend iterator operator + (iterator lhs, difference_type rhs) {
+                    return lhs += rhs;}
+
+                // ----------
+                // operator -
+                // ----------
+
+                /**
+                 * @param lhs an iterator
+                 * @param rhs a difference_type which is the amount being subtracted.
+                 * @return an iterator
+                 * (lhs - rhs) => iterator
+                 */
+                friend iterator operator - (iterator lhs, difference_type rhs) {
+                    return lhs -= rhs;}
+
+                /**
+                 * @param lhs a const iterator reference
+                 * @param rhs a const iterator reference
+                 * @return a difference_type, the distance from rhs to lhs
+                 */
+                friend difference_type operator - (const iterator& lhs, const iterator& rhs) {
+                    return lhs._idx - rhs._idx;}
+
+            private:
+                // ----
+                // data
+                // ----
+
+                MyIndexedDeque* _deque;
+
+                size_type _idx;
+
+                // The leaf holding _idx and the offset in it, or 0 until the next dereference.
+                mutable Node* _leaf;
+                mutable size_type _off;
+
+            public:
+                // -----------
+                // constructor
+                // -----------
+
+                /**
+                 * @param d a pointer to MyIndexedDeque
+                 * @param i a size_type
+                 */
+                iterator (MyIndexedDeque* d, size_type i = 0)
+                    : _deque(d), _idx(i), _leaf(0), _off(0) {}
+
+                // Default copy, destructor, and copy assignment.
+
+                // ----------
+                // operator *
+                // ----------
+
+                /**
+                 * @return reference
+                 * Finds the leaf once, then walks within it until it runs out
+                 */
+                reference operator * () const {
+                    if (!_leaf) {
+                        _off  = _idx;
+                        _leaf = _deque->locate(_off);}
+                    return _leaf->_data[_leaf->_gap + _off];}
+
+                // -----------
+                // operator ->
+                // -----------
+
+                /**
+                 * @return pointer
+                 */
+                pointer operator -> () const {
+                    return &**this;}
+
+                // -----------
+                // operator []
+                // -----------
+
+                /**
+                 * @param d a difference_type
+                 * @return reference
+                 */
+                reference operator [] (difference_type d) const {
+                    return *(*this + d);}
+
+                // -----------
+                // operator ++
+                // -----------
+
+                /**
+                 * @return reference to iterator
+                 * Pre-increment this
+                 */
+                iterator& operator ++ () {
+                    ++_idx;
+                    if (_leaf && (++_off == _leaf->_n))
+                        _leaf = 0;
+                    return *this;}
+
+                /**
+                 * @return an iterator
+                 * Post-increment this
+                 */
+                iterator operator ++ (int) {
+                    iterator x = *this;
+                    ++(*this);
+                    return x;}
+
+                // -----------
+                // operator --
+                // -----------
+
+                /**
+                 * @return reference to iterator
+                 * Pre-decrement this
+                 */
+                iterator& operator -- () {
+                    --_idx;
+                    if (_leaf && (_off-- == 0))
+                        _leaf = 0;
+                    return *this;}
+
+                /**
+                 * @return an iterator
+                 * Post-decrement this
+                 */
+                iterator operator -- (int) {
+                    iterator x = *this;
+                    --(*this);
+                    return x;}
+
+                // -----------
+                // operator +=
+                // -----------
+
+                /**
+                 * @param d a difference_type which is the amount that is added
+                 * @return an iterator reference
+                 * (this + d) => this
+                 */
+                iterator& operator += (difference_type d) {
+                    _idx += d;
+                    _leaf = 0;
+                    return *this;}
+
+                // -----------
+                // operator -=
+                // -----------
+
+                /**
+                 * @param d a difference_type which is the amount that is subtracted
+                 * @return an iterator reference
+                 * (this - d) => this
+                 */
+                iterator& operator -= (difference_type d) {
+                    _idx -= d;
+                    _leaf = 0;
+                    return *this;}
+
+                // -----
+                // index
+                // -----
+
+                /**
+                 * @return a size_type, the position of this in its deque
+                 */
+                size_type index () const {
+                    return _idx;}};
+
+    public:
+        // --------------
+        // const_iterator
+        // --------------
+
+        class const_iterator {
+            public:
+                // --------
+                // typedefs
+                // --------
+
+                typedef std::random_access_iterator_tag      iterator_category;
+                typedef typename MyIndexedDeque::value_type      value_type;
+                typedef typename MyIndexedDeque::difference_type difference_type;
+                typedef typename MyIndexedDeque::const_pointer   pointer;
+                typedef typename MyIndexedDeque::const_reference reference;
+                typedef typename MyIndexedDeque::size_type       size_type;
+
+            public:
+                // -----------
+                // operator ==
+                // -----------
+
+                /**
+                 * @param lhs a const const_iterator reference
+                 * @param rhs a const const_iterator reference
+                 * @return a true if equal or false if not
+                 * (lhs == rhs) => true or false
+                 */
+                friend bool operator == (const const_iterator& lhs, const const_iterator& rhs) {
+                    return (lhs._cDeque == rhs._cDeque) && (lhs._idx == rhs._idx);}
+
+                /**
+                 * @param lhs a const const_iterator reference
+                 * @param rhs a const const_iterator reference
+                 * @return a false if equal or true if not
+                 * (lhs != rhs) => true or false
+                 */
+                friend bool operator != (const const_iterator& lhs, const const_iterator& rhs) {
+                    return !(lhs == rhs);}
+
+                // ----------
+                // operator <
+                // ----------
+
+                /**
+                 * @param lhs a const const_iterator reference
+                 * @param rhs a const const_iterator reference
+                 * @return a true if lhs comes before rhs
+                 */
+                friend bool operator < (const const_iterator& lhs, const const_iterator& rhs) {
+                    return lhs._idx < rhs._idx;}
+
+                // ----------
+                // operator +
+                // ----------
+
+                /**
+                 * @param lhs a const_iterator
+                 * @param rhs a difference_type which is the amount being added.
+                 * @return a const_iterator
+                 * (lhs + rhs) => const_iterator
+                 */
+                friend const_iterator operator + (const_iterator lhs, difference_type rhs) {
+                    return lhs += rhs;}
+
+                // ----------
+                // operator -
+                // ----------
+
+                /**
+                 * @param lhs a const_iterator
+                 * @param rhs a difference_type which is the amount being subtracted.
+                 * @return a const_iterator
+                 * (lhs - rhs) => const_iterator
+                 */
+                friend const_iterator operator - (const_iterator lhs, difference_type rhs) {
+                    return lhs -= rhs;}
+
+                /**
+                 * @param lhs a const const_iterator reference
+                 * @param rhs a const const_iterator reference
+                 * @return a difference_type, the distance from rhs to lhs
+                 */
+                friend difference_type operator - (const const_iterator& lhs, const const_iterator& rhs) {
+                    return lhs._idx - rhs._idx;}
+
+            private:
+                // ----
+                // data
+                // ----
+
+                const MyIndexedDeque* _cDeque;
+
+                size_type _idx;
+
+                mutable const Node* _leaf;
+                mutable size_type _off;
+
+            public:
+                // -----------
+                // constructor
+                // -----------
+
+                /**
+                 * @param d a const pointer to MyIndexedDeque
+                 * @param i a size_type
+                 */
+                const_iterator (const MyIndexedDeque* d, size_type i)
+                    : _cDeque(d), _idx(i), _leaf(0), _off(0) {}
+
+                // Default copy, destructor, and copy assignment.
+
+                // ----------
+                // operator *
+                // ----------
+
+                /**
+                 * @return a const_reference
+                 */
+                reference operator * () const {
+                    if (!_leaf) {
+                        _off  = _idx;
+                        _leaf = _cDeque->locate(_off);}
+                    return _leaf->_data[_leaf->_gap + _off];}
+
+                // -----------
+                // operator ->
+                // -----------
+
+                /**
+                 * @return pointer
+                 */
+                pointer operator -> () const {
+                    return &**this;}
+
+                // -----------
+                // operator []
+                // -----------
+
+                /**
+                 * @param d a difference_type
+                 * @return a const_reference
+                 */
+                reference operator [] (difference_type d) const {
+                    return *(*this + d);}
+
+                // -----------
+                // operator ++
+                // -----------
+
+                /**
+                 * @return reference to const_iterator
+                 * Pre-increment this
+                 */
+                const_iterator& operator ++ () {
+                    ++_idx;
+                    if (_leaf && (++_off == _leaf->_n))
+                        _leaf = 0;
+                    return *this;}
+
+                /**
+                 * @return a const_iterator
+                 * Post-increment this
+                 */
+                const_iterator operator ++ (int) {
+                    const_iterator x = *this;
+                    ++(*this);
+                    return x;}
+
+                // -----------
+                // operator --
+                // -----------
+
+                /**
+                 * @return reference to const_iterator
+                 * Pre-decrement this
+                 */
+                const_iterator& operator -- () {
+                    --_idx;
+                    if (_leaf && (_off-- == 0))
+                        _leaf = 0;
+                    return *this;}
+
+                /**
+                 * @return a const_iterator
+                 * Post-decrement this
+                 */
+                const_iterator operator -- (int) {
+                    const_iterator x = *this;
+                    --(*this);
+                    return x;}
+
+                // -----------
+                // operator +=
+                // -----------
+
+                /**
+                 * @param d a difference_type which is the amount that is added
+                 * @return a const_iterator reference
+                 * (this + d) => this
+                 */
+                const_iterator& operator += (difference_type d) {
+                    _idx += d;
+                    _leaf = 0;
+                    return *this;}
+
+                // -----------
+                // operator -=
+                // -----------
+
+                /**
+                 * @param d a difference_type which is the amount that is subtracted
+                 * @return a const_iterator reference
+                 * (this - d) => this
+                 */
+                const_iterator& operator -= (difference_type d) {
+                    _idx -= d;
+                    _leaf = 0;
+                    return *this;}};
+
+    public:
+        // ------------
+        // constructors
+        // ------------
+
+        /**
+         * @param a a const allocator_type reference that is defaulted
+         * Default constructor
+         */
+        explicit MyIndexedDeque (const allocator_type& a = allocator_type())
+            : _a(a), _aNode(), _root(0), _first(0), _last(0), _front(0), _back(0), _spare(0) {
+            assert(valid());}
+
+        /**
+         * @param s a size_type
+         * @param v a const_reference that is defaulted
+         * @param a a const allocator_type reference that is defaulted
+         * Constructor with size specification
+         */
+        explicit MyIndexedDeque (size_type s, const_reference v = value_type(), const allocator_type& a = allocator_type())
+            : _a(a), _aNode(), _root(0), _first(0), _last(0), _front(0), _back(0), _spare(0) {
+            resize(s, v);
+            assert(valid());}
+
+        /**
+         * @param that a const MyIndexedDeque reference
+         * Copy constructor
+         */
+        MyIndexedDeque (const MyIndexedDeque& that)
+            : _a(that._a), _aNode(), _root(0), _first(0), _last(0), _front(0), _back(0), _spare(0) {
+            try {
+                for (const_iterator p = that.begin(); p != that.end(); ++p)
+                    push_back(*p);}
+            catch (...) {
+                clear();
+                throw;}
+            assert(valid());}
+
+        // ----------
+        // destructor
+        // ----------
+
+        /**
+         * Destroys every element and frees every block
+         */
+        ~MyIndexedDeque () {
+            clear();
+            assert(valid());}
+
+        // ----------
+        // operator =
+        // ----------
+
+        /**
+         * @param rhs a const MyIndexedDeque reference
+         * @return a MyIndexedDeque reference
+         */
+        MyIndexedDeque& operator = (const MyIndexedDeque& rhs) {
+            if (this == &rhs)
+                return *this;
+            MyIndexedDeque d(rhs);
+            swap(d);
+            assert(valid());
+            return *this;}
+
+        // -----------
+        // operator []
+        // -----------
+
+        /**
+         * @param index a size_type
+         * @return a reference
+         * O(log n) indexing operator
+         */
+        reference operator [] (size_type index) {
+            Node* x = locate(index);
+            return x->_data[x->_gap + index];}
+
+        /**
+         * @param index a size_type
+         * @return a const reference
+         */
+        const_reference operator [] (size_type index) const {
+            return const_cast<MyIndexedDeque*>(this)->operator[](index);}
+
+        // --
+        // at
+        // --
+
+        /**
+         * @param index a size_type
+         * @return a reference
+         * Throw if index is out of bounds
+         */
+        reference at (size_type index) {
+            if (index >= size())
+                throw std::out_of_range("Out of bounds.");
+            return (*this)[index];}
+
+        /**
+         * @param index a size_type
+         * @return a const_reference
+         */
+        const_reference at (size_type index) const {
+            return const_cast<MyIndexedDeque*>(this)->at(index);}
+
+        // ----
+        // back
+        // ----
+
+        /**
+         * @return a reference to the last element
+         */
+        reference back () {
+            assert(size() != 0);
+            return _last->_data[_last->_gap + _last->_n - 1];}
+
+        /**
+         * @return a const reference to the last element
+         */
+        const_reference back () const {
+            return const_cast<MyIndexedDeque*>(this)->back();}
+
+        // -----
+        // begin
+        // -----
+
+        /**
+         * @return an iterator
+         */
+        iterator begin () {
+            return iterator(this, 0);}
+
+        /**
+         * @return a const_iterator
+         */
+        const_iterator begin () const {
+            return const_iterator(this, 0);}
+
+        // -----
+        // clear
+        // -----
+
+        /**
+         * Destroys every element and frees every block
+         */
+        void clear () {
+            if (_root)
+                release(_root);
+            _root  = _first = _last = 0;
+            _front = _back = 0;
+            assert(valid());}
+
+        // -----
+        // empty
+        // -----
+
+        /**
+         * @return a bool
+         */
+        bool empty () const {
+            return !size();}
+
+        // ---
+        // end
+        // ---
+
+        /**
+         * @return an iterator
+         */
+        iterator end () {
+            return iterator(this, size());}
+
+        /**
+         * @return a const_iterator
+         */
+        const_iterator end () const {
+            return const_iterator(this, size());}
+
+        // -----
+        // erase
+        // -----
+
+        /**
+         * @param i an iterator
+         * @return an iterator to the element that followed the erased one
+         * O(log n) at any position
+         */
+        iterator erase (iterator i) {
+            const size_type index = i.index();
+            assert(index < size());
+            sync();
+            erase(_root, index);
+            while (!_root->_leaf && (_root->_n == 1)) {
+                Node* x = _root->_child[0];
+                free(_root);
+                _root = x;}
+            cache();
+            assert(valid());
+            return iterator(this, index);}
+
+        // -----
+        // front
+        // -----
+
+        /**
+         * @return a reference to the first element
+         */
+        reference front () {
+            assert(size() != 0);
+            return _first->_data[_first->_gap];}
+
+        /**
+         * @return a const_reference to the first element
+         */
+        const_reference front () const {
+            return const_cast<MyIndexedDeque*>(this)->front();}
+
+        // ------
+        // insert
+        // ------
+
+        /**
+         * @param i an iterator
+         * @param v a const_reference which is the value inserted
+         * @return an iterator to the inserted value
+         * O(log n) at any position. Every node it needs is allocated before
+         * anything moves, so a failed allocation leaves the deque untouched.
+         */
+        iterator insert (iterator i, const_reference v) {
+            const size_type index = i.index();
+            assert(index <= size());
+            const value_type t(v);
+            sync();
+            if (!_root) {
+                _root = make(true);
+                cache();}
+            reserve(index);
+            Node* y = insert(_root, index, t);
+            if (y) {
+                Node* x = take(false);
+                x->_child[0] = _root;
+                x->_child[1] = y;
+                x->_n    = 2;
+                x->_size = _root->_size + y->_size;
+                _root = x;}
+            unreserve();
+            cache();
+            assert(valid());
+            return iterator(this, index);}
+
+        // --------
+        // pop_back
+        // --------
+
+        /**
+         * Removes the back element, O(1) unless it empties the last leaf
+         */
+        void pop_back () {
+            assert(size() != 0);
+            Node* x = _last;
+            if (x->_n == 1) {
+                erase(end() - 1);
+                return;}
+            --x->_n;
+            --x->_size;
+            --_back;
+            allocator_traits_type::destroy(_a, x->_data + x->_gap + x->_n);}
+
+        // ---------
+        // pop_front
+        // ---------
+
+        /**
+         * Removes the front element, O(1) unless it empties the first leaf
+         */
+        void pop_front () {
+            assert(size() != 0);
+            Node* x = _first;
+            if (x->_n == 1) {
+                erase(begin());
+                return;}
+            allocator_traits_type::destroy(_a, x->_data + x->_gap);
+            ++x->_gap;
+            --x->_n;
+            --x->_size;
+            --_front;}
+
+        // ---------
+        // push_back
+        // ---------
+
+        /**
+         * @param v a const_reference
+         * Appends a copy of v at the end, O(1) unless the last leaf is full
+         */
+        void push_back (const_reference v) {
+            Node* x = _last;
+            if (!x || (x->_n == COLUMNS)) {
+                insert(end(), v);
+                return;}
+            if (x->_gap + x->_n == COLUMNS) {
+                const value_type t(v);
+                slide(x, (x == _first) ? (COLUMNS - x->_n) / 2 : 0);
+                allocator_traits_type::construct(_a, x->_data + x->_gap + x->_n, t);}
+            else
+                allocator_traits_type::construct(_a, x->_data + x->_gap + x->_n, v);
+            ++x->_n;
+            ++x->_size;
+            ++_back;}
+
+        // ----------
+        // push_front
+        // ----------
+
+        /**
+         * @param v a const_reference
+         * Prepends a copy of v at the front, O(1) unless the first leaf is full
+         */
+        void push_front (const_reference v) {
+            Node* x = _first;
+            if (!x || (x->_n == COLUMNS)) {
+                insert(begin(), v);
+                return;}
+            if (x->_gap == 0) {
+                const value_type t(v);
+                slide(x, (x == _last) ? (COLUMNS - x->_n + 1) / 2 : COLUMNS - x->_n);
+                allocator_traits_type::construct(_a, x->_data + x->_gap - 1, t);}
+            else
+                allocator_traits_type::construct(_a, x->_data + x->_gap - 1, v);
+            --x->_gap;
+            ++x->_n;
+            ++x->_size;
+            ++_front;}
+
+        // ------
+        // resize
+        // ------
+
+        /**
+         * @param s a size_type
+         * @param v a const reference that is defaulted
+         * Resize with v filling up the new spaces
+         */
+        void resize (size_type s, const_reference v = value_type()) {
+            while (size() > s)
+                pop_back();
+            while (size() < s)
+                push_back(v);
+            assert(valid());}
+
+        // ----
+        // size
+        // ----
+
+        /**
+         * @return size_type
+         */
+        size_type size () const {
+            return _root ? count(_root, true, true) : 0;}
+
+        // ----
+        // swap
+        // ----
+
+        /**
+         * @param that a MyIndexedDeque reference
+         * Swap the contents of that and this.
+         */
+        void swap (MyIndexedDeque& that) {
+            if (_a != that._a) {
+                MyIndexedDeque d(*this);
+                *this = that;
+                that = d;}
+            else {
+                std::swap(_root,  that._root);
+                std::swap(_first, that._first);
+                std::swap(_last,  that._last);
+                std::swap(_front, that._front);
+                std::swap(_back,  that._back);}
+            assert(valid());}};
+
+#endif // IndexedDeque_h
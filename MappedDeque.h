@@ -0,0 +1,504 @@
+// ----------------------------
+// projects/deque/MappedDeque.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// ----------------------------
+
+#ifndef MappedDeque_h
+#define MappedDeque_h
+
+// --------
+// includes
+// --------
+
+#include <cassert> // assert
+#include <cerrno> // errno
+#include <cstring> // memcpy, memmove, memcmp
+#include <stdexcept> // out_of_range, runtime_error
+#include <system_error> // system_category, system_error
+#include <type_traits> // is_trivially_copyable
+
+#include <fcntl.h> // open, O_CREAT, O_RDWR
+#include <stdint.h> // uint32_t, uint64_t
+#include <sys/mman.h> // mmap, mremap, msync, munmap
+#include <sys/stat.h> // fstat
+#include <unistd.h> // close, ftruncate
+
+// -------------
+// MyMappedDeque
+// -------------
+
+/**
+ * A deque of trivially copyable T whose storage is a memory-mapped file.
+ * The file starts with a one-page header that records the capacity and the
+ * front and back offsets of the elements, followed by the element buffer,
+ * laid out like MyDeque's [_front, _back) with the elements in [_b, _e).
+ * Reopening a file maps it back in place; nothing is read or deserialized,
+ * and element access goes straight to the page cache.
+ * Changes reach the file when the kernel writes the pages back; sync() forces it.
+ * Only open, is_open, close, size, empty, at, begin and end may be called
+ * on a deque that isn't open; the rest assert that it is.
+ */
+template <typename T>
+class MyMappedDeque {
+    static_assert(std::is_trivially_copyable<T>::value, "MyMappedDeque requires a trivially copyable T");
+
+    public:
+    // --------
+    // typedefs
+    // --------
+
+    typedef T           value_type;
+
+    typedef std::size_t    size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    typedef T*          pointer;
+    typedef const T*    const_pointer;
+
+    typedef T&          reference;
+    typedef const T&    const_reference;
+
+    typedef T*          iterator;
+    typedef const T*    const_iterator;
+
+private:
+    // ------
+    // Header
+    // ------
+
+    /**
+     * The persistent header at the start of the file.
+     * _b and _e are element offsets into the buffer that follows the header.
+     */
+    struct Header {
+        char     _magic[8];
+        uint32_t _version;
+        uint32_t _width;
+        uint64_t _capacity;
+        uint64_t _b;
+        uint64_t _e;};
+
+    static const char*  magic   () {return "MyDeque";}
+    static const uint32_t VERSION = 1;
+    static const size_type HEADER = 4096;
+    static const size_type INITIAL = (HEADER / sizeof(T)) ? (HEADER / sizeof(T)) : 1;
+
+private:
+    // ----
+    // data
+    // ----
+
+    int     _fd;
+    char*   _map;
+    size_type _length;
+
+    private:
+        // -----
+        // valid
+        // -----
+
+        bool valid () const {
+            return (_fd == -1) ? !_map : (_map && (header()._b <= header()._e) && (header()._e <= header()._capacity));}
+
+        // ------
+        // header
+        // ------
+
+        Header& header () const {
+            return *reinterpret_cast<Header*>(_map);}
+
+        // ------
+        // buffer
+        // ------
+
+        pointer buffer () const {
+            return reinterpret_cast<pointer>(_map + HEADER);}
+
+        // ----
+        // fail
+        // ----
+
+        /**
+         * @param what a const char* naming the failed call
+         * Throws a system_error for errno
+         */
+        static void fail (const char* what) {
+            throw std::system_error(errno, std::system_category(), what);}
+
+        // ----
+        // grow
+        // ----
+
+        /**
+         * @param c a size_type, the new capacity in elements
+         * @param o a size_type, the offset the elements move to
+         * Extends the file and the mapping to c elements and moves [_b, _e) to start at o
+         */
+        void grow (size_type c, size_type o) {
+            const size_type s = size();
+            assert((c >= header()._capacity) && (o + s <= c));
+            if (c != header()._capacity) {
+                const size_type length = HEADER + c * sizeof(T);
+                if (::ftruncate(_fd, length) == -1)
+                    fail("ftruncate");
+                void* p = ::mremap(_map, _length, length, MREMAP_MAYMOVE);
+                if (p == MAP_FAILED)
+                    fail("mremap");
+                _map    = static_cast<char*>(p);
+                _length = length;
+                header()._capacity = c;}
+            std::memmove(buffer() + o, buffer() + header()._b, s * sizeof(T));
+            header()._b = o;
+            header()._e = o + s;}
+
+        // ------
+        // ensure
+        // ------
+
+        /**
+         * @param front a bool, true if the next element goes in front
+         * Makes room for one more element at the given end,
+         * recentering in place when the buffer is at most half full and doubling it otherwise
+         */
+        void ensure (bool front) {
+            const Header& h = header();
+            if (front ? (h._b != 0) : (h._e != h._capacity))
+                return;
+            const size_type s = size();
+            const size_type c = (2 * (s + 1) <= h._capacity) ? h._capacity : 2 * h._capacity;
+            grow(c, (c - s) / 2);}
+
+    private:
+        // Not copyable: two deques must not share a mapping.
+        MyMappedDeque (const MyMappedDeque&);
+        MyMappedDeque& operator = (const MyMappedDeque&);
+
+    public:
+        // ------------
+        // constructors
+        // ------------
+
+        /**
+         * Default constructor, not open
+         */
+        MyMappedDeque ()
+            : _fd(-1), _map(0), _length(0) {
+            assert(valid());}
+
+        /**
+         * @param path a const char*
+         * Opens path, see open()
+         */
+        explicit MyMappedDeque (const char* path)
+            : _fd(-1), _map(0), _length(0) {
+            open(path);
+            assert(valid());}
+
+        // ----------
+        // destructor
+        // ----------
+
+        /**
+         * Unmaps and closes the file; the kernel still writes back dirty pages
+         */
+        ~MyMappedDeque () {
+            close();}
+
+        // ----
+        // open
+        // ----
+
+        /**
+         * @param path a const char*
+         * Maps path, creating an empty deque if the file is new or empty.
+         * Throws runtime_error if the file holds a different version or element size,
+         * and system_error if a system call fails.
+         */
+        void open (const char* path) {
+            close();
+            _fd = ::open(path, O_RDWR | O_CREAT, 0644);
+            if (_fd == -1)
+                fail("open");
+            try {
+                struct stat st;
+                if (::fstat(_fd, &st) == -1)
+                    fail("fstat");
+                const bool created = (st.st_size == 0);
+                if (created) {
+                    if (::ftruncate(_fd, HEADER + INITIAL * sizeof(T)) == -1)
+                        fail("ftruncate");
+                    st.st_size = HEADER + INITIAL * sizeof(T);}
+                else if (static_cast<size_type>(st.st_size) < HEADER)
+                    throw std::runtime_error("MyMappedDeque: truncated header");
+                void* p = ::mmap(0, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+                if (p == MAP_FAILED)
+                    fail("mmap");
+                _map    = static_cast<char*>(p);
+                _length = st.st_size;
+                Header& h = header();
+                if (created) {
+                    std::memcpy(h._magic, magic(), sizeof(h._magic));
+                    h._version  = VERSION;
+                    h._width    = sizeof(T);
+                    h._capacity = INITIAL;
+                    h._b = h._e = INITIAL / 2;}
+                else if (std::memcmp(h._magic, magic(), sizeof(h._magic)) || (h._version != VERSION) || (h._width != sizeof(T)))
+                    throw std::runtime_error("MyMappedDeque: not a deque of this type");
+                else if ((h._capacity == 0) || (h._b > h._e) || (h._e > h._capacity) || (HEADER + h._capacity * sizeof(T) > _length))
+                    throw std::runtime_error("MyMappedDeque: corrupt header");}
+            catch (...) {
+                close();
+                throw;}
+            assert(valid());}
+
+        // -------
+        // is_open
+        // -------
+
+        /**
+         * @return a bool
+         */
+        bool is_open () const {
+            return _fd != -1;}
+
+        // ----
+        // sync
+        // ----
+
+        /**
+         * Writes the header and the elements back to the file and waits for it
+         */
+        void sync () {
+            assert(is_open());
+            if (::msync(_map, _length, MS_SYNC) == -1)
+                fail("msync");}
+
+        // -----
+        // close
+        // -----
+
+        /**
+         * Unmaps and closes the file without waiting for write back
+         */
+        void close () {
+            if (_map)
+                ::munmap(_map, _length);
+            if (_fd != -1)
+                ::close(_fd);
+            _fd     = -1;
+            _map    = 0;
+            _length = 0;
+            assert(valid());}
+
+        // -----------
+        // operator []
+        // -----------
+
+        /**
+         * @param index a size_type
+         * @return a reference into the mapping
+         */
+        reference operator [] (size_type index) {
+            assert(is_open());
+            return buffer()[header()._b + index];}
+
+        /**
+         * @param index a size_type
+         * @return a const reference into the mapping
+         */
+        const_reference operator [] (size_type index) const {
+            return const_cast<MyMappedDeque*>(this)->operator[](index);}
+
+        // --
+        // at
+        // --
+
+        /**
+         * @param index a size_type
+         * @return a reference
+         * Throw if index is out of bounds
+         */
+        reference at (size_type index) {
+            if (index >= size())
+                throw std::out_of_range("Out of bounds.");
+            return (*this)[index];}
+
+        /**
+         * @param index a size_type
+         * @return a const_reference
+         */
+        const_reference at (size_type index) const {
+            return const_cast<MyMappedDeque*>(this)->at(index);}
+
+        // ----
+        // back
+        // ----
+
+        /**
+         * @return a reference to the last element
+         */
+        reference back () {
+            assert(is_open());
+            assert(size() != 0);
+            return buffer()[header()._e - 1];}
+
+        /**
+         * @return a const reference to the last element
+         */
+        const_reference back () const {
+            return const_cast<MyMappedDeque*>(this)->back();}
+
+        // -----
+        // begin
+        // -----
+
+        /**
+         * @return an iterator, invalidated when the deque grows, or 0 if the deque isn't open
+         */
+        iterator begin () {
+            return _map ? buffer() + header()._b : 0;}
+
+        /**
+         * @return a const_iterator
+         */
+        const_iterator begin () const {
+            return const_cast<MyMappedDeque*>(this)->begin();}
+
+        // -----
+        // clear
+        // -----
+
+        /**
+         * Empties the deque without shrinking the file
+         */
+        void clear () {
+            assert(is_open());
+            header()._b = header()._e = header()._capacity / 2;
+            assert(valid());}
+
+        // -----
+        // empty
+        // -----
+
+        /**
+         * @return a bool
+         */
+        bool empty () const {
+            return !size();}
+
+        // ---
+        // end
+        // ---
+
+        /**
+         * @return an iterator, or 0 if the deque isn't open
+         */
+        iterator end () {
+            return _map ? buffer() + header()._e : 0;}
+
+        /**
+         * @return a const_iterator
+         */
+        const_iterator end () const {
+            return const_cast<MyMappedDeque*>(this)->end();}
+
+        // -----
+        // front
+        // -----
+
+        /**
+         * @return a reference to the first element
+         */
+        reference front () {
+            assert(is_open());
+            assert(size() != 0);
+            return buffer()[header()._b];}
+
+        /**
+         * @return a const_reference to the first element
+         */
+        const_reference front () const {
+            return const_cast<MyMappedDeque*>(this)->front();}
+
+        // --------
+        // pop_back
+        // --------
+
+        /**
+         * Removes the back element
+         */
+        void pop_back () {
+            assert(is_open());
+            assert(size() != 0);
+            --header()._e;
+            assert(valid());}
+
+        // ---------
+        // pop_front
+        // ---------
+
+        /**
+         * Removes the front element
+         */
+        void pop_front () {
+            assert(is_open());
+            assert(size() != 0);
+            ++header()._b;
+            assert(valid());}
+
+        // ---------
+        // push_back
+        // ---------
+
+        /**
+         * @param v a const_reference
+         * Appends a copy of v at the end
+         */
+        void push_back (const_reference v) {
+            assert(is_open());
+            const value_type t(v);
+            ensure(false);
+            buffer()[header()._e++] = t;
+            assert(valid());}
+
+        // ----------
+        // push_front
+        // ----------
+
+        /**
+         * @param v a const_reference
+         * Prepends a copy of v at the front
+         */
+        void push_front (const_reference v) {
+            assert(is_open());
+            const value_type t(v);
+            ensure(true);
+            buffer()[--header()._b] = t;
+            assert(valid());}
+
+        // -------
+        // reserve
+        // -------
+
+        /**
+         * @param c a size_type
+         * Grows the file so that c elements fit without remapping, keeping the elements centered
+         */
+        void reserve (size_type c) {
+            assert(is_open());
+            if (c > header()._capacity)
+                grow(c, (c - size()) / 2);
+            assert(valid());}
+
+        // ----
+        // size
+        // ----
+
+        /**
+         * @return size_type
+         */
+        size_type size () const {
+            return _map ? header()._e - header()._b : 0;}};
+
+#endif // MappedDeque_h
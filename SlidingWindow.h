@@ -0,0 +1,336 @@
+// ------------------------------
+// projects/deque/SlidingWindow.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// ------------------------------
+
+#ifndef SlidingWindow_h
+#define SlidingWindow_h
+
+// --------
+// includes
+// --------
+
+#include <cassert> // assert
+#include <cstddef> // size_t
+#include <functional> // less
+
+#include "Deque.h"
+
+// -----------------
+// MyMonotonicWindow
+// -----------------
+
+/**
+ * The best value in a sliding window, by a strict weak order: the minimum
+ * with less<T> (the default), the maximum with greater<T>.
+ * Every value is pushed with a key, a tick count or a timestamp, and keys
+ * must not decrease; evict(k) drops the values whose key is less than k,
+ * so count- and time-based windows are the same class.
+ * Only the values that could still become the best are kept, ordered
+ * from best to newest in a MyDeque, so push, evict, and top are O(1) amortized.
+ */
+template <typename T, typename Compare = std::less<T>, typename K = long>
+class MyMonotonicWindow {
+    public:
+    // --------
+    // typedefs
+    // --------
+
+    typedef T           value_type;
+    typedef K           key_type;
+    typedef Compare     value_compare;
+
+    typedef std::size_t size_type;
+
+private:
+    // ----
+    // Item
+    // ----
+
+    struct Item {
+        K _k;
+        T _v;};
+
+private:
+    // ----
+    // data
+    // ----
+
+    MyDeque<Item> _q;
+    Compare       _c;
+
+    private:
+        // -----
+        // valid
+        // -----
+
+        bool valid () const {
+            const size_type s = _q.size();
+            return (s < 2) || (_c(_q[s - 2]._v, _q[s - 1]._v) && !(_q[s - 1]._k < _q[s - 2]._k));}
+
+    public:
+        // ------------
+        // constructors
+        // ------------
+
+        /**
+         * @param c a Compare
+         */
+        explicit MyMonotonicWindow (const Compare& c = Compare())
+            : _c(c) {}
+
+        // Default copy, destructor, and copy assignment.
+
+        // -----
+        // clear
+        // -----
+
+        void clear () {
+            _q.clear();}
+
+        // -----
+        // empty
+        // -----
+
+        /**
+         * @return true if no value in the window is left
+         */
+        bool empty () const {
+            return _q.empty();}
+
+        // -----
+        // evict
+        // -----
+
+        /**
+         * @param k a key_type
+         * Drops every value whose key is less than k
+         */
+        void evict (const K& k) {
+            while (!_q.empty() && (_q.front()._k < k))
+                _q.pop_front();}
+
+        // ----
+        // push
+        // ----
+
+        /**
+         * @param k a key_type, not less than any key pushed before
+         * @param v a value_type
+         * Drops the values that v outlasts and beats, then appends v
+         */
+        void push (const K& k, const T& v) {
+            assert(_q.empty() || !(k < _q.back()._k));
+            while (!_q.empty() && !_c(_q.back()._v, v))
+                _q.pop_back();
+            const Item i = {k, v};
+            _q.push_back(i);
+            assert(valid());}
+
+        // ----
+        // size
+        // ----
+
+        /**
+         * @return the number of candidates kept, not the size of the window
+         */
+        size_type size () const {
+            return _q.size();}
+
+        // ---
+        // top
+        // ---
+
+        /**
+         * @return the best value in the window
+         */
+        const T& top () const {
+            assert(!empty());
+            return _q.front()._v;}
+
+        // -------
+        // top_key
+        // -------
+
+        /**
+         * @return the key of top()
+         */
+        const K& top_key () const {
+            assert(!empty());
+            return _q.front()._k;}};
+
+// -----------------
+// MyWindowAggregate
+// -----------------
+
+/**
+ * Any associative aggregate, such as a sum, product, min, or gcd, over a
+ * sliding window, with Op combining an older value on the left with a
+ * newer one on the right. Op needs no identity and need not be commutative.
+ * The window is kept as two stacks in MyDeques: the newer values, with one
+ * running aggregate of all of them, and the older values, each stored with
+ * the aggregate from it through the newest of the older values. When the
+ * older stack runs out, the newer one is flipped into it, computing those
+ * aggregates once; each value is combined O(1) times, so push, pop, and get
+ * are O(1) amortized.
+ * Like MyMonotonicWindow, values carry nondecreasing keys for evict(k);
+ * pop() drops the oldest value for count-based windows.
+ */
+template <typename T, typename Op, typename K = long>
+class MyWindowAggregate {
+    public:
+    // --------
+    // typedefs
+    // --------
+
+    typedef T           value_type;
+    typedef K           key_type;
+
+    typedef std::size_t size_type;
+
+private:
+    // ----
+    // Item
+    // ----
+
+    struct Item {
+        K _k;
+        T _v;
+        T _a;};
+
+private:
+    // ----
+    // data
+    // ----
+
+    MyDeque<Item> _old;
+    MyDeque<Item> _new;
+    T             _a;
+    Op            _op;
+
+    private:
+        // ----
+        // flip
+        // ----
+
+        /**
+         * Moves the newer values into the empty older stack, oldest in front,
+         * each with the aggregate from it through the newest
+         */
+        void flip () {
+            assert(_old.empty() && !_new.empty());
+            Item i = _new.back();
+            i._a = i._v;
+            _old.push_front(i);
+            _new.pop_back();
+            while (!_new.empty()) {
+                i = _new.back();
+                i._a = _op(i._v, _old.front()._a);
+                _old.push_front(i);
+                _new.pop_back();}}
+
+        // -----
+        // front
+        // -----
+
+        const Item& front () {
+            if (_old.empty())
+                flip();
+            return _old.front();}
+
+    public:
+        // ------------
+        // constructors
+        // ------------
+
+        /**
+         * @param op an Op
+         */
+        explicit MyWindowAggregate (const Op& op = Op())
+            : _a(), _op(op) {}
+
+        // Default copy, destructor, and copy assignment.
+
+        // -----
+        // clear
+        // -----
+
+        void clear () {
+            _old.clear();
+            _new.clear();}
+
+        // -----
+        // empty
+        // -----
+
+        /**
+         * @return a bool
+         */
+        bool empty () const {
+            return _old.empty() && _new.empty();}
+
+        // -----
+        // evict
+        // -----
+
+        /**
+         * @param k a key_type
+         * Drops every value whose key is less than k
+         */
+        void evict (const K& k) {
+            while (!empty() && (front()._k < k))
+                _old.pop_front();}
+
+        // ---
+        // get
+        // ---
+
+        /**
+         * @return the aggregate of the window, oldest value first
+         */
+        T get () const {
+            assert(!empty());
+            if (_new.empty())
+                return _old.front()._a;
+            if (_old.empty())
+                return _a;
+            return _op(_old.front()._a, _a);}
+
+        // ---
+        // pop
+        // ---
+
+        /**
+         * Drops the oldest value
+         */
+        void pop () {
+            assert(!empty());
+            front();
+            _old.pop_front();}
+
+        // ----
+        // push
+        // ----
+
+        /**
+         * @param k a key_type, not less than any key pushed before
+         * @param v a value_type
+         */
+        void push (const K& k, const T& v) {
+            assert(empty() || !(k < (_new.empty() ? _old.back()._k : _new.back()._k)));
+            _a = _new.empty() ? v : _op(_a, v);
+            const Item i = {k, v, v};
+            _new.push_back(i);}
+
+        // ----
+        // size
+        // ----
+
+        /**
+         * @return the number of values in the window
+         */
+        size_type size () const {
+            return _old.size() + _new.size();}};
+
+#endif // SlidingWindow_h
@@ -0,0 +1,489 @@
+// -------------------------
+// projects/deque/SoADeque.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// -------------------------
+
+#ifndef SoADeque_h
+#define SoADeque_h
+
+// --------
+// includes
+// --------
+
+#include <cassert> // assert
+#include <cstddef> // size_t
+#include <stdexcept> // out_of_range
+#include <tuple> // get, tuple, tuple_element
+
+#include "Deque.h"
+
+// ---------
+// MyIndices
+// ---------
+
+/**
+ * A compile-time list of indices, for expanding over the fields of a tuple.
+ * MyMakeIndices<N>::type is MyIndices<0, 1, ..., N - 1>.
+ */
+template <std::size_t... I>
+struct MyIndices {};
+
+template <std::size_t N, std::size_t... I>
+struct MyMakeIndices : MyMakeIndices<N - 1, N - 1, I...> {};
+
+template <std::size_t... I>
+struct MyMakeIndices<0, I...> {
+    typedef MyIndices<I...> type;};
+
+// --------
+// MyColumn
+// --------
+
+/**
+ * A view of n contiguous elements, valid until the deque it came from
+ * grows, shrinks, or is cleared.
+ */
+template <typename T>
+class MyColumn {
+    public:
+    // --------
+    // typedefs
+    // --------
+
+    typedef T           value_type;
+    typedef std::size_t size_type;
+    typedef T*          iterator;
+
+private:
+    // ----
+    // data
+    // ----
+
+    T*        _p;
+    size_type _n;
+
+    public:
+        /**
+         * @param p a pointer
+         * @param n a size_type
+         */
+        MyColumn (T* p, size_type n)
+            : _p(p), _n(n) {}
+
+        T& operator [] (size_type i) const {
+            assert(i < _n);
+            return _p[i];}
+
+        iterator begin () const {
+            return _p;}
+
+        T* data () const {
+            return _p;}
+
+        bool empty () const {
+            return !_n;}
+
+        iterator end () const {
+            return _p + _n;}
+
+        size_type size () const {
+            return _n;}};
+
+// ----------
+// MySoADeque
+// ----------
+
+/**
+ * A deque of tuples of Fields stored column by column: field I of every
+ * element lives in its own MyDeque, so a scan over one field reads only
+ * that field's memory, contiguously, and can be vectorized.
+ * Elements are pushed and popped at both ends and indexed like MyDeque;
+ * operator [] returns a proxy, a tuple of references into the columns,
+ * and column<I>() returns a MyColumn over field I of every element.
+ * A push or a resize that throws partway through leaves the deque unchanged.
+ */
+template <typename... Fields>
+class MySoADeque {
+    static_assert(sizeof...(Fields) != 0, "MySoADeque requires at least one field");
+
+    public:
+    // --------
+    // typedefs
+    // --------
+
+    typedef std::tuple<Fields...>        value_type;
+
+    typedef std::size_t                  size_type;
+    typedef std::ptrdiff_t               difference_type;
+
+    typedef std::tuple<Fields&...>       reference;
+    typedef std::tuple<const Fields&...> const_reference;
+
+    template <std::size_t I>
+    struct field {
+        typedef typename std::tuple_element<I, value_type>::type type;};
+
+    static const std::size_t FIELDS = sizeof...(Fields);
+
+    public:
+    // -----------
+    // operator ==
+    // -----------
+
+    /**
+     * @param lhs a const MySoADeque reference
+     * @param rhs a const MySoADeque reference
+     * @return true if every column is equal
+     */
+    friend bool operator == (const MySoADeque& lhs, const MySoADeque& rhs) {
+        return lhs._c == rhs._c;}
+
+    /**
+     * @param lhs a const MySoADeque reference
+     * @param rhs a const MySoADeque reference
+     * @return a bool
+     */
+    friend bool operator != (const MySoADeque& lhs, const MySoADeque& rhs) {
+        return !(lhs == rhs);}
+
+private:
+    // --------
+    // typedefs
+    // --------
+
+    typedef typename MyMakeIndices<sizeof...(Fields)>::type indices;
+    typedef int                                            swallow[];
+
+private:
+    // ----
+    // data
+    // ----
+
+    std::tuple< MyDeque<Fields>... > _c;
+
+    private:
+        // -----
+        // valid
+        // -----
+
+        template <std::size_t... I>
+        bool valid (MyIndices<I...>) const {
+            bool b = true;
+            (void)swallow{0, (b = b && (std::get<I>(_c).size() == size()), 0)...};
+            return b;}
+
+        bool valid () const {
+            return valid(indices());}
+
+        // ---
+        // get
+        // ---
+
+        template <std::size_t... I>
+        reference get (size_type i, MyIndices<I...>) {
+            return reference(std::get<I>(_c)[i]...);}
+
+        template <std::size_t... I>
+        const_reference get (size_type i, MyIndices<I...>) const {
+            return const_reference(std::get<I>(_c)[i]...);}
+
+        // ----
+        // push
+        // ----
+
+        /**
+         * Pushes field I of v onto column I, in order, and pops what was
+         * pushed if one of them throws
+         */
+        template <std::size_t... I>
+        void push_back (const value_type& v, MyIndices<I...>) {
+            std::size_t n = 0;
+            try {
+                (void)swallow{0, (std::get<I>(_c).push_back(std::get<I>(v)), ++n, 0)...};}
+            catch (...) {
+                (void)swallow{0, ((I < n) ? (std::get<I>(_c).pop_back(), 0) : 0)...};
+                throw;}}
+
+        template <std::size_t... I>
+        void push_front (const value_type& v, MyIndices<I...>) {
+            std::size_t n = 0;
+            try {
+                (void)swallow{0, (std::get<I>(_c).push_front(std::get<I>(v)), ++n, 0)...};}
+            catch (...) {
+                (void)swallow{0, ((I < n) ? (std::get<I>(_c).pop_front(), 0) : 0)...};
+                throw;}}
+
+        // ---
+        // pop
+        // ---
+
+        template <std::size_t... I>
+        void pop_back (MyIndices<I...>) {
+            (void)swallow{0, (std::get<I>(_c).pop_back(), 0)...};}
+
+        template <std::size_t... I>
+        void pop_front (MyIndices<I...>) {
+            (void)swallow{0, (std::get<I>(_c).pop_front(), 0)...};}
+
+        // ------
+        // resize
+        // ------
+
+        /**
+         * Resizes column I to s, in order, and shrinks the columns already
+         * grown back to their old size if one of them throws
+         */
+        template <std::size_t... I>
+        void resize (size_type s, const value_type& v, MyIndices<I...>) {
+            const size_type o = size();
+            std::size_t n = 0;
+            try {
+                (void)swallow{0, (std::get<I>(_c).resize(s, std::get<I>(v)), ++n, 0)...};}
+            catch (...) {
+                (void)swallow{0, ((I < n) ? (std::get<I>(_c).resize(o, std::get<I>(v)), 0) : 0)...};
+                throw;}}
+
+        // -----
+        // clear
+        // -----
+
+        template <std::size_t... I>
+        void clear (MyIndices<I...>) {
+            (void)swallow{0, (std::get<I>(_c).clear(), 0)...};}
+
+        // ----
+        // swap
+        // ----
+
+        template <std::size_t... I>
+        void swap (MySoADeque& that, MyIndices<I...>) {
+            (void)swallow{0, (std::get<I>(_c).swap(std::get<I>(that._c)), 0)...};}
+
+    public:
+        // ------------
+        // constructors
+        // ------------
+
+        /**
+         * Default constructor
+         */
+        MySoADeque () {
+            assert(valid());}
+
+        /**
+         * @param s a size_type
+         * @param v a const value_type reference that is defaulted
+         */
+        explicit MySoADeque (size_type s, const value_type& v = value_type()) {
+            resize(s, v);
+            assert(valid());}
+
+        // Default copy, destructor, and copy assignment.
+
+        // -----------
+        // operator []
+        // -----------
+
+        /**
+         * @param index a size_type
+         * @return a tuple of references to the fields of element index
+         */
+        reference operator [] (size_type index) {
+            return get(index, indices());}
+
+        /**
+         * @param index a size_type
+         * @return a tuple of const references
+         */
+        const_reference operator [] (size_type index) const {
+            return get(index, indices());}
+
+        // --
+        // at
+        // --
+
+        /**
+         * @param index a size_type
+         * @return a tuple of references
+         * Throw if index is out of bounds
+         */
+        reference at (size_type index) {
+            if (index >= size())
+                throw std::out_of_range("Out of bounds.");
+            return (*this)[index];}
+
+        /**
+         * @param index a size_type
+         * @return a tuple of const references
+         */
+        const_reference at (size_type index) const {
+            return const_cast<MySoADeque*>(this)->at(index);}
+
+        // ----
+        // back
+        // ----
+
+        /**
+         * @return a tuple of references to the last element
+         */
+        reference back () {
+            assert(!empty());
+            return (*this)[size() - 1];}
+
+        /**
+         * @return a tuple of const references to the last element
+         */
+        const_reference back () const {
+            assert(!empty());
+            return (*this)[size() - 1];}
+
+        // -----
+        // clear
+        // -----
+
+        void clear () {
+            clear(indices());
+            assert(valid());}
+
+        // ------
+        // column
+        // ------
+
+        /**
+         * @return field I of every element, contiguous
+         */
+        template <std::size_t I>
+        MyColumn<typename field<I>::type> column () {
+            MyDeque<typename field<I>::type>& c = std::get<I>(_c);
+            return MyColumn<typename field<I>::type>(c.empty() ? 0 : &c[0], c.size());}
+
+        /**
+         * @return field I of every element, contiguous and read only
+         */
+        template <std::size_t I>
+        MyColumn<const typename field<I>::type> column () const {
+            const MyDeque<typename field<I>::type>& c = std::get<I>(_c);
+            return MyColumn<const typename field<I>::type>(c.empty() ? 0 : &c[0], c.size());}
+
+        // -----
+        // empty
+        // -----
+
+        /**
+         * @return a bool
+         */
+        bool empty () const {
+            return !size();}
+
+        // -----
+        // front
+        // -----
+
+        /**
+         * @return a tuple of references to the first element
+         */
+        reference front () {
+            assert(!empty());
+            return (*this)[0];}
+
+        /**
+         * @return a tuple of const references to the first element
+         */
+        const_reference front () const {
+            assert(!empty());
+            return (*this)[0];}
+
+        // ---
+        // get
+        // ---
+
+        /**
+         * @param index a size_type
+         * @return a reference to field I of element index
+         */
+        template <std::size_t I>
+        typename field<I>::type& get (size_type index) {
+            return std::get<I>(_c)[index];}
+
+        /**
+         * @param index a size_type
+         * @return a const reference to field I of element index
+         */
+        template <std::size_t I>
+        const typename field<I>::type& get (size_type index) const {
+            return std::get<I>(_c)[index];}
+
+        // --------
+        // pop_back
+        // --------
+
+        void pop_back () {
+            assert(!empty());
+            pop_back(indices());
+            assert(valid());}
+
+        // ---------
+        // pop_front
+        // ---------
+
+        void pop_front () {
+            assert(!empty());
+            pop_front(indices());
+            assert(valid());}
+
+        // ---------
+        // push_back
+        // ---------
+
+        /**
+         * @param v a const value_type reference
+         */
+        void push_back (const value_type& v) {
+            push_back(v, indices());
+            assert(valid());}
+
+        // ----------
+        // push_front
+        // ----------
+
+        /**
+         * @param v a const value_type reference
+         */
+        void push_front (const value_type& v) {
+            push_front(v, indices());
+            assert(valid());}
+
+        // ------
+        // resize
+        // ------
+
+        /**
+         * @param s a size_type
+         * @param v a const value_type reference that is defaulted
+         */
+        void resize (size_type s, const value_type& v = value_type()) {
+            resize(s, v, indices());
+            assert(valid());}
+
+        // ----
+        // size
+        // ----
+
+        /**
+         * @return a size_type
+         */
+        size_type size () const {
+            return std::get<0>(_c).size();}
+
+        // ----
+        // swap
+        // ----
+
+        /**
+         * @param that a MySoADeque reference
+         */
+        void swap (MySoADeque& that) {
+            swap(that, indices());}};
+
+#endif // SoADeque_h
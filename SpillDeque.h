@@ -0,0 +1,594 @@
+// ---------------------------
+// projects/deque/SpillDeque.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// ---------------------------
+
+#ifndef SpillDeque_h
+#define SpillDeque_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // max
+#include <atomic> // atomic
+#include <cassert> // assert
+#include <cerrno> // errno
+#include <condition_variable> // condition_variable
+#include <cstdlib> // free, malloc
+#include <mutex> // lock_guard, mutex, unique_lock
+#include <new> // bad_alloc
+#include <set> // set
+#include <stdexcept> // out_of_range
+#include <string> // string
+#include <system_error> // system_category, system_error
+#include <thread> // thread
+#include <type_traits> // is_trivially_copyable
+
+#include <stdlib.h> // mkstemp
+#include <unistd.h> // close, pread, pwrite, unlink
+
+#include "Deque.h"
+#include "DequeBlocks.h"
+
+// ------------
+// MySpillDeque
+// ------------
+
+/**
+ * A deque of trivially copyable T that keeps at most a memory budget of its
+ * blocks resident and spills the rest to an unlinked temporary file.
+ * The first PREFETCH + 1 blocks and the last block, where consumers and
+ * producers work, are never spilled; the victim is the resident block
+ * nearest the back among the others, since that is the one the consumer
+ * will reach last. Each time the front crosses into a new block, the next
+ * PREFETCH spilled blocks are read back on a background thread. Any other
+ * access to a spilled block reads it back synchronously.
+ * A block that has not been written since it was last read back is
+ * dropped without being written again.
+ */
+template <typename T>
+class MySpillDeque {
+    static_assert(std::is_trivially_copyable<T>::value, "MySpillDeque requires a trivially copyable T");
+
+    public:
+    // --------
+    // typedefs
+    // --------
+
+    typedef T           value_type;
+
+    typedef std::size_t    size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    typedef T*          pointer;
+    typedef const T*    const_pointer;
+
+    typedef T&          reference;
+    typedef const T&    const_reference;
+
+private:
+    // -----
+    // Block
+    // -----
+
+    /**
+     * _data is 0 while the block lives only in the file at _slot.
+     * _loading is set while the background thread reads it into _data.
+     */
+    struct Block {
+        pointer           _data;
+        off_t             _slot;
+        bool              _dirty;
+        std::atomic<bool> _loading;
+
+        Block ()
+            : _data(0), _slot(-1), _dirty(true), _loading(false) {}};
+
+    static const size_type PREFETCH = 2;    // blocks read back ahead of the front
+
+private:
+    // ----
+    // data
+    // ----
+
+    BlockRing<Block> _ring;
+    const size_type  _budget;   // resident blocks
+
+    std::set<long long> _resident;
+    MyDeque<off_t>  _free;
+    off_t           _end;
+    int             _fd;
+
+    std::mutex              _m;
+    std::condition_variable _cv;
+    MyDeque<Block*>         _requests;
+    bool                    _stop;
+    std::thread             _worker;
+
+    private:
+        // ----
+        // fail
+        // ----
+
+        static void fail (const char* what) {
+            throw std::system_error(errno, std::system_category(), what);}
+
+        // -----
+        // bytes
+        // -----
+
+        size_type bytes () const {
+            return _ring._columns * sizeof(T);}
+
+        // ----
+        // work
+        // ----
+
+        /**
+         * The background thread: reads requested blocks back from the file.
+         */
+        void work () {
+            std::unique_lock<std::mutex> l(_m);
+            while (true) {
+                while (!_stop && _requests.empty())
+                    _cv.wait(l);
+                if (_stop)
+                    return;
+                Block* b = _requests.front();
+                _requests.pop_front();
+                l.unlock();
+                const bool ok = (::pread(_fd, b->_data, bytes(), b->_slot) == static_cast<ssize_t>(bytes()));
+                l.lock();
+                if (!ok)
+                    b->_dirty = true;      // the reader finds out in wait() and retries synchronously
+                b->_loading.store(false);
+                _cv.notify_all();}}
+
+        // ----
+        // idle
+        // ----
+
+        /**
+         * @param b a pointer to a Block
+         * Returns once the background thread isn't reading b back
+         */
+        void idle (Block* b) {
+            std::unique_lock<std::mutex> l(_m);
+            while (b->_loading.load())
+                _cv.wait(l);}
+
+        // ----
+        // wait
+        // ----
+
+        /**
+         * @param k a size_type, a position in _blocks
+         * Returns once the block isn't being read back, reading it again,
+         * without holding _m, if the background read failed
+         */
+        void wait (size_type k) {
+            Block* b = _ring._blocks[k];
+            if (!b->_loading.load())
+                return;
+            idle(b);
+            if (b->_dirty) {
+                try {
+                    read(b);}
+                catch (...) {
+                    _resident.erase(_ring._first + k);
+                    throw;}}}
+
+        // ----
+        // read
+        // ----
+
+        /**
+         * @param b a pointer to a Block with a buffer and a slot
+         * If the read fails, frees the buffer, so that the block is spilled
+         * again and the copy in the file is the one a later access reads
+         */
+        void read (Block* b) {
+            if (::pread(_fd, b->_data, bytes(), b->_slot) != static_cast<ssize_t>(bytes())) {
+                const int e = errno;
+                std::free(b->_data);
+                b->_data  = 0;
+                b->_dirty = false;
+                errno = e;
+                fail("pread");}
+            b->_dirty = false;}
+
+        // -----
+        // spill
+        // -----
+
+        /**
+         * @param id a long long, the id of a resident block that isn't being read back
+         * Writes the block to the file if it changed since it was last read, then frees it
+         */
+        void spill (long long id) {
+            Block* b = _ring._blocks[id - _ring._first];
+            assert(b->_data && !b->_loading.load());
+            if (b->_dirty) {
+                if (b->_slot == -1) {
+                    if (_free.empty()) {
+                        b->_slot = _end;
+                        _end += bytes();}
+                    else {
+                        b->_slot = _free.back();
+                        _free.pop_back();}}
+                if (::pwrite(_fd, b->_data, bytes(), b->_slot) != static_cast<ssize_t>(bytes()))
+                    fail("pwrite");
+                b->_dirty = false;}
+            std::free(b->_data);
+            b->_data = 0;
+            _resident.erase(id);}
+
+        // -----
+        // evict
+        // -----
+
+        /**
+         * @param pin a long long, the id of a block that must stay resident
+         * Spills interior blocks, nearest the back first, until the budget is met
+         */
+        void evict (long long pin) {
+            const long long front = _ring._first + static_cast<long long>(PREFETCH);
+            const long long back  = _ring.last();
+            std::set<long long>::iterator p = _resident.end();
+            while ((_resident.size() > _budget) && (p != _resident.begin())) {
+                --p;
+                const long long id = *p;
+                if ((id <= front) || (id >= back) || (id == pin) || _ring._blocks[id - _ring._first]->_loading.load())
+                    continue;
+                std::set<long long>::iterator q = p;
+                ++q;
+                spill(id);
+                p = q;}}
+
+        // ----
+        // make
+        // ----
+
+        /**
+         * @return a pointer to a resident block buffer
+         */
+        pointer make () {
+            pointer p = static_cast<pointer>(std::malloc(bytes()));
+            if (!p)
+                throw std::bad_alloc();
+            return p;}
+
+        // -----
+        // block
+        // -----
+
+        /**
+         * @param k a size_type, a position in _blocks
+         * @param write a bool, true if the caller will change the block
+         * @return the block's buffer, reading it back first if it was spilled
+         */
+        pointer block (size_type k, bool write) {
+            Block* b = _ring._blocks[k];
+            wait(k);
+            if (!b->_data) {
+                b->_data = make();
+                read(b);
+                _resident.insert(_ring._first + k);
+                evict(_ring._first + k);}
+            if (write)
+                b->_dirty = true;
+            return b->_data;}
+
+        // --------
+        // prefetch
+        // --------
+
+        /**
+         * Starts reading back the spilled blocks among the first PREFETCH + 1
+         */
+        void prefetch () {
+            bool queued = false;
+            for (size_type k = 0; (k <= PREFETCH) && (k < _ring._blocks.size()); ++k) {
+                Block* b = _ring._blocks[k];
+                if (b->_data)
+                    continue;
+                b->_data = make();
+                b->_loading.store(true);
+                _resident.insert(_ring._first + k);
+                std::lock_guard<std::mutex> l(_m);
+                _requests.push_back(b);
+                queued = true;}
+            if (queued)
+                _cv.notify_all();}
+
+        // ----
+        // open
+        // ----
+
+        void open (Block* b) {
+            b->_data = make();}
+
+        // ------
+        // opened
+        // ------
+
+        void opened (long long id) {
+            _resident.insert(id);
+            evict(id);}
+
+        // ----
+        // drop
+        // ----
+
+        /**
+         * @param k a size_type, a position in _blocks
+         * Frees the block's buffer and returns its slot to the file
+         */
+        void drop (size_type k) {
+            Block* b = _ring._blocks[k];
+            if (b->_loading.load())
+                idle(b);
+            if (b->_data) {
+                std::free(b->_data);
+                _resident.erase(_ring._first + k);}
+            if (b->_slot != -1)
+                _free.push_back(b->_slot);}
+
+        // -----
+        // ended
+        // -----
+
+        /**
+         * @param k a size_type, a position in _blocks
+         * Prefetches ahead when the front has left a block
+         */
+        void ended (size_type k) {
+            if (k == 0)
+                prefetch();}
+
+        // -----
+        // write
+        // -----
+
+        pointer write (size_type k) {
+            return block(k, true);}
+
+    private:
+        friend struct BlockRing<Block>;
+
+        // Not copyable: the file and the thread are owned.
+        MySpillDeque (const MySpillDeque&);
+        MySpillDeque& operator = (const MySpillDeque&);
+
+    public:
+        // ------------
+        // constructors
+        // ------------
+
+        /**
+         * @param budget a size_type, the bytes of blocks to keep resident
+         * @param dir a const char*, the directory for the spill file
+         * @param block a size_type, the bytes per block
+         * The budget is raised if needed to cover the blocks that are never spilled.
+         */
+        explicit MySpillDeque (size_type budget = 64 << 20, const char* dir = "/tmp", size_type block = 64 << 10)
+            : _ring((block / sizeof(T)) ? (block / sizeof(T)) : 1),
+              _budget(std::max<size_type>(budget / (_ring._columns * sizeof(T)), PREFETCH + 3)),
+              _resident(), _free(), _end(0), _fd(-1),
+              _requests(), _stop(false) {
+            std::string path = std::string(dir) + "/MySpillDeque.XXXXXX";
+            _fd = ::mkstemp(&path[0]);
+            if (_fd == -1)
+                fail("mkstemp");
+            ::unlink(path.c_str());
+            try {
+                _worker = std::thread(&MySpillDeque::work, this);}
+            catch (...) {
+                ::close(_fd);
+                throw;}
+            assert(_ring.valid());}
+
+        // ----------
+        // destructor
+        // ----------
+
+        /**
+         * Stops the background thread, frees every block, and closes the spill file
+         */
+        ~MySpillDeque () {
+            {
+            std::lock_guard<std::mutex> l(_m);
+            _stop = true;}
+            _cv.notify_all();
+            _worker.join();
+            for (size_type k = 0; k != _ring._blocks.size(); ++k) {
+                std::free(_ring._blocks[k]->_data);
+                delete _ring._blocks[k];}
+            ::close(_fd);}
+
+        // -----------
+        // operator []
+        // -----------
+
+        /**
+         * @param index a size_type
+         * @return a reference, valid until the next operation on this deque
+         */
+        reference operator [] (size_type index) {
+            const size_type i = _ring._head + index;
+            return block(i / _ring._columns, true)[i % _ring._columns];}
+
+        /**
+         * @param index a size_type
+         * @return a const reference, valid until the next operation on this deque
+         */
+        const_reference operator [] (size_type index) const {
+            MySpillDeque* d = const_cast<MySpillDeque*>(this);
+            const size_type i = _ring._head + index;
+            return d->block(i / _ring._columns, false)[i % _ring._columns];}
+
+        // --
+        // at
+        // --
+
+        /**
+         * @param index a size_type
+         * @return a reference
+         * Throw if index is out of bounds
+         */
+        reference at (size_type index) {
+            if (index >= size())
+                throw std::out_of_range("Out of bounds.");
+            return (*this)[index];}
+
+        /**
+         * @param index a size_type
+         * @return a const_reference
+         */
+        const_reference at (size_type index) const {
+            if (index >= size())
+                throw std::out_of_range("Out of bounds.");
+            return (*this)[index];}
+
+        // ----
+        // back
+        // ----
+
+        /**
+         * @return a reference to the last element
+         */
+        reference back () {
+            assert(size() != 0);
+            return (*this)[_ring._size - 1];}
+
+        /**
+         * @return a const reference to the last element
+         */
+        const_reference back () const {
+            assert(size() != 0);
+            return (*this)[_ring._size - 1];}
+
+        // -----
+        // clear
+        // -----
+
+        /**
+         * Drops every element and block
+         */
+        void clear () {
+            _ring.clear(*this);
+            assert(_ring.valid());}
+
+        // -----
+        // empty
+        // -----
+
+        /**
+         * @return a bool
+         */
+        bool empty () const {
+            return !size();}
+
+        // -----
+        // front
+        // -----
+
+        /**
+         * @return a reference to the first element
+         */
+        reference front () {
+            assert(size() != 0);
+            return (*this)[0];}
+
+        /**
+         * @return a const_reference to the first element
+         */
+        const_reference front () const {
+            assert(size() != 0);
+            return (*this)[0];}
+
+        // --------
+        // pop_back
+        // --------
+
+        /**
+         * Removes the back element
+         */
+        void pop_back () {
+            assert(size() != 0);
+            _ring.pop_back(*this);
+            assert(_ring.valid());}
+
+        // ---------
+        // pop_front
+        // ---------
+
+        /**
+         * Removes the front element, prefetching ahead when it leaves a block
+         */
+        void pop_front () {
+            assert(size() != 0);
+            _ring.pop_front(*this);
+            assert(_ring.valid());}
+
+        // ---------
+        // push_back
+        // ---------
+
+        /**
+         * @param v a const_reference
+         * Appends a copy of v at the end
+         */
+        void push_back (const_reference v) {
+            _ring.push_back(*this, value_type(v));
+            assert(_ring.valid());}
+
+        // ----------
+        // push_front
+        // ----------
+
+        /**
+         * @param v a const_reference
+         * Prepends a copy of v at the front
+         */
+        void push_front (const_reference v) {
+            _ring.push_front(*this, value_type(v));
+            assert(_ring.valid());}
+
+        // ------
+        // resize
+        // ------
+
+        /**
+         * @param s a size_type
+         * @param v a const reference that is defaulted
+         */
+        void resize (size_type s, const_reference v = value_type()) {
+            while (size() > s)
+                pop_back();
+            while (size() < s)
+                push_back(v);}
+
+        // --------
+        // resident
+        // --------
+
+        /**
+         * @return the number of blocks in memory, at most the budget plus the ends
+         */
+        size_type resident () const {
+            return _resident.size();}
+
+        // ----
+        // size
+        // ----
+
+        /**
+         * @return size_type
+         */
+        size_type size () const {
+            return _ring._size;}};
+
+#endif // SpillDeque_h
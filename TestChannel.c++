@@ -0,0 +1,194 @@
+// -----------------------------
+// projects/deque/TestChannel.c++
+// Copyright (C) 2013
+// Glenn P. Downing
+// -----------------------------
+
+/*
+To test the program:
+% g++ -pedantic -std=c++20 -Wall -pthread TestChannel.c++ -o TestChannel -lcppunit -ldl
+% valgrind TestChannel > TestChannel.out
+*/
+
+// --------
+// includes
+// --------
+
+#include <atomic> // atomic
+#include <optional> // optional
+#include <thread> // yield
+
+#include "cppunit/extensions/HelperMacros.h" // CPPUNIT_TEST, CPPUNIT_TEST_SUITE, CPPUNIT_TEST_SUITE_END
+#include "cppunit/TestFixture.h" // TestFixture
+#include "cppunit/TestSuite.h" // TestSuite
+#include "cppunit/TextTestRunner.h" // TestRunner
+
+#include "Channel.h"
+
+// ----------
+// coroutines
+// ----------
+
+MyTask produce (MyChannel<int>& c, int b, int e, bool close) {
+    for (int i = b; i != e; ++i)
+        co_await c.push(i);
+    if (close)
+        c.close();}
+
+MyTask consume (MyChannel<int>& c, std::atomic<long>& sum, std::atomic<int>& done) {
+    while (std::optional<int> v = co_await c.pop())
+        sum += *v;
+    ++done;}
+
+MyTask consume_batch (MyChannel<int>& c, MyDeque<int>& out, std::size_t max, int& batches) {
+    while (true) {
+        const std::size_t n = co_await c.pop_batch(out, max);
+        if (n == 0)
+            break;
+        ++batches;}}
+
+MyTask push_one (MyChannel<int>& c, int v, int& result) {
+    result = co_await c.push(v);}
+
+// -----------
+// TestChannel
+// -----------
+
+struct TestChannel : CppUnit::TestFixture {
+
+    // --------------
+    // test_unbounded
+    // --------------
+
+    void test_unbounded () {
+        MyInlineExecutor e;
+        MyChannel<int> c(e);
+        std::atomic<long> sum(0);
+        std::atomic<int>  done(0);
+        spawn(e, produce(c, 0, 1000, true));
+        e.run();
+        spawn(e, consume(c, sum, done));
+        e.run();
+        assert(sum == 499500);
+        assert(done == 1);}
+
+    // ------------
+    // test_bounded
+    // ------------
+
+    void test_bounded () {
+        MyInlineExecutor e;
+        MyChannel<int> c(e, 2);
+        int r = -1;
+        spawn(e, push_one(c, 1, r));
+        spawn(e, push_one(c, 2, r));
+        e.run();
+        assert(r == 1);
+        r = -1;
+        spawn(e, push_one(c, 3, r));
+        e.run();
+        assert(r == -1);
+        std::atomic<long> sum(0);
+        std::atomic<int>  done(0);
+        spawn(e, consume(c, sum, done));
+        e.run();
+        assert(r == 1);
+        assert(sum == 6);
+        c.close();
+        e.run();
+        assert(done == 1);}
+
+    // ---------------
+    // test_rendezvous
+    // ---------------
+
+    void test_rendezvous () {
+        MyInlineExecutor e;
+        MyChannel<int> c(e, 0);
+        std::atomic<long> sum(0);
+        std::atomic<int>  done(0);
+        spawn(e, consume(c, sum, done));
+        spawn(e, produce(c, 1, 101, true));
+        e.run();
+        assert(sum == 5050);
+        assert(done == 1);}
+
+    // ----------
+    // test_batch
+    // ----------
+
+    void test_batch () {
+        MyInlineExecutor e;
+        MyChannel<int> c(e);
+        MyDeque<int> out;
+        int batches = 0;
+        spawn(e, produce(c, 0, 25, true));
+        spawn(e, consume_batch(c, out, 10, batches));
+        e.run();
+        assert(out.size() == 25);
+        assert(batches == 3);
+        assert(out[24] == 24);}
+
+    // ----------
+    // test_close
+    // ----------
+
+    void test_close () {
+        MyInlineExecutor e;
+        MyChannel<int> c(e, 1);
+        int r = -1;
+        c.close();
+        spawn(e, push_one(c, 1, r));
+        e.run();
+        assert(r == 0);
+        assert(c.closed());}
+
+    // ----------------
+    // test_thread_pool
+    // ----------------
+
+    void test_thread_pool () {
+        std::atomic<long> sum(0);
+        std::atomic<int>  done(0);
+        {
+        MyThreadPool p(4);
+        MyChannel<int> c(p, 16);
+        for (int i = 0; i != 4; ++i)
+            spawn(p, consume(c, sum, done));
+        for (int i = 0; i != 4; ++i)
+            spawn(p, produce(c, i * 10000, (i + 1) * 10000, false));
+        while (sum != 799980000L)
+            std::this_thread::yield();
+        c.close();
+        while (done != 4)
+            std::this_thread::yield();}
+        assert(sum == 799980000L);}
+
+    // -----
+    // suite
+    // -----
+
+    CPPUNIT_TEST_SUITE(TestChannel);
+    CPPUNIT_TEST(test_unbounded);
+    CPPUNIT_TEST(test_bounded);
+    CPPUNIT_TEST(test_rendezvous);
+    CPPUNIT_TEST(test_batch);
+    CPPUNIT_TEST(test_close);
+    CPPUNIT_TEST(test_thread_pool);
+    CPPUNIT_TEST_SUITE_END();};
+
+// ----
+// main
+// ----
+
+int main () {
+    using namespace std;
+    ios_base::sync_with_stdio(false); // turn off synchronization with C I/O
+    cout << "TestChannel.c++" << endl;
+
+    CppUnit::TextTestRunner tr;
+    tr.addTest(TestChannel::suite());
+    tr.run();
+
+    cout << "Done." << endl;
+    return 0;}
@@ -20,16 +20,41 @@ TestFixture.h
 // includes
 // --------
 
-#include <algorithm> // copy, count, fill, reverse
+#include <algorithm> // copy, count, fill, is_sorted, lower_bound, max_element, min_element, reverse, sort, stable_sort
+#include <atomic> // atomic
+#include <csignal> // signal, SIGXFSZ
+#include <cstdio> // remove
+#include <fcntl.h> // open
+#include <sys/resource.h> // getrlimit, setrlimit
+#include <unistd.h> // close, lseek, pwrite
+#include <cstddef> // ptrdiff_t, size_t
+#include <cstdlib> // rand, srand
 #include <deque> // deque
+#include <functional> // greater, plus
+#include <iterator> // istream_iterator
 #include <memory> // allocator
+#include <new> // bad_alloc
+#include <set> // set
+#include <sstream> // istringstream
+#include <stdexcept> // runtime_error
+#include <string> // string
+#include <system_error> // system_error
 
 #include "cppunit/extensions/HelperMacros.h" // CPPUNIT_TEST, CPPUNIT_TEST_SUITE, CPPUNIT_TEST_SUITE_END
 #include "cppunit/TestFixture.h" // TestFixture
 #include "cppunit/TestSuite.h" // TestSuite
 #include "cppunit/TextTestRunner.h" // TestRunner
 
+#include "CompressedDeque.h"
 #include "Deque.h"
+#include "DequeBlocks.h"
+#include "IndexedDeque.h"
+#include "DequeStream.h"
+#include "HugePageAllocator.h"
+#include "MappedDeque.h"
+#include "SlidingWindow.h"
+#include "SoADeque.h"
+#include "SpillDeque.h"
 
 // ---------
 // TestDeque
@@ -256,6 +281,17 @@ struct TestDeque : CppUnit::TestFixture {
         assert(p == x.begin());
         assert(x == y);}
 
+    void test_erase3 () {
+        C x;
+        for (int i = 0; i != 500; ++i)
+            x.push_back(i);
+        for (int i = 0; i != 200; ++i)
+            x.erase(x.begin() + 150);
+        assert(x.size() == 300);
+        assert(x[149] == 149);
+        assert(x[150] == 350);
+        assert(x.back() == 499);}
+
     // ----------
     // test_front
     // ----------
@@ -283,6 +319,17 @@ struct TestDeque : CppUnit::TestFixture {
         C x(10, 2);
         typename C::iterator p = x.insert(x.begin(), 3);
         assert(p == x.begin());}
+
+    void test_insert2 () {
+        C x;
+        for (int i = 0; i != 500; ++i)
+            x.insert(x.begin() + x.size() / 2, i);
+        assert(x.size() == 500);
+        assert(x[249] == 499);
+        assert(x[250] == 498);
+        assert(x[251] == 496);
+        assert(x.front() == 1);
+        assert(x.back() == 0);}
         
 
     // -------------
@@ -377,6 +424,22 @@ struct TestDeque : CppUnit::TestFixture {
         std::fill(x.begin(), x.end(), 2);
         std::reverse(x.begin(), x.end());}
 
+    // ----------------
+    // test_random_sort
+    // ----------------
+
+    void test_random_sort () {
+        C x;
+        for (int i = 0; i != 100; ++i)
+            x.push_back((i * 37) % 100);
+        std::sort(x.begin(), x.end());
+        assert(std::is_sorted(x.begin(), x.end()));
+        assert(x.end() - x.begin() == 100);
+        assert(x.begin() < x.end());
+        assert(x.begin()[99] == 99);
+        const C& y = x;
+        assert(*std::lower_bound(y.begin(), y.end(), 50) == 50);}
+
     // -----
     // suite
     // -----
@@ -404,9 +467,11 @@ struct TestDeque : CppUnit::TestFixture {
     CPPUNIT_TEST(test_end);
     CPPUNIT_TEST(test_erase1);
     CPPUNIT_TEST(test_erase2);
+    CPPUNIT_TEST(test_erase3);
     CPPUNIT_TEST(test_front);
     CPPUNIT_TEST(test_push_front);
     CPPUNIT_TEST(test_insert);
+    CPPUNIT_TEST(test_insert2);
     CPPUNIT_TEST(test_pop_back);
     CPPUNIT_TEST(test_push_back);
     CPPUNIT_TEST(test_resize);
@@ -416,6 +481,1688 @@ struct TestDeque : CppUnit::TestFixture {
     CPPUNIT_TEST(test_const_iterator1);
     CPPUNIT_TEST(test_const_iterator2);
     CPPUNIT_TEST(test_algorithms);
+    CPPUNIT_TEST(test_random_sort);
+    CPPUNIT_TEST_SUITE_END();};
+
+// ---------------
+// TestMappedDeque
+// ---------------
+
+struct TestMappedDeque : CppUnit::TestFixture {
+    const char* path;
+
+    void setUp () {
+        path = "TestMappedDeque.dat";
+        std::remove(path);}
+
+    void tearDown () {
+        std::remove(path);}
+
+    // ---------
+    // test_open
+    // ---------
+
+    void test_open () {
+        MyMappedDeque<int> x(path);
+        assert(x.is_open());
+        assert(x.empty());
+        x.close();
+        assert(!x.is_open());
+        assert(x.begin() == x.end());
+        const MyMappedDeque<int> y;
+        assert(y.begin() == 0);
+        assert(y.end() == 0);
+        assert(std::distance(y.begin(), y.end()) == 0);}
+
+    // -----------
+    // test_reopen
+    // -----------
+
+    void test_reopen () {
+        {
+        MyMappedDeque<int> x(path);
+        for (int i = 0; i != 5000; ++i) {
+            x.push_back(i);
+            x.push_front(-i);}
+        x.pop_front();
+        x.pop_back();
+        x.sync();}
+        MyMappedDeque<int> y(path);
+        assert(y.size() == 9998);
+        assert(y.front() == -4998);
+        assert(y.back() == 4998);
+        assert(y[4998] == 0);}
+
+    // ---------
+    // test_fifo
+    // ---------
+
+    void test_fifo () {
+        MyMappedDeque<long> x(path);
+        for (long i = 0; i != 100000; ++i) {
+            x.push_back(i);
+            if (i >= 10)
+                x.pop_front();}
+        assert(x.size() == 10);
+        assert(x.front() == 99990);
+        assert(x.at(9) == 99999);}
+
+    // ----------
+    // test_width
+    // ----------
+
+    void test_width () {
+        {
+        MyMappedDeque<int> x(path);
+        x.push_back(1);}
+        MyMappedDeque<double> y;
+        try {
+            y.open(path);
+            assert(false);}
+        catch (const std::runtime_error&) {
+            assert(!y.is_open());}}
+
+    // -------------
+    // test_capacity
+    // -------------
+
+    void test_capacity () {
+        {
+        MyMappedDeque<int> x(path);
+        x.push_back(1);}
+        const int fd = ::open(path, O_RDWR);
+        assert(fd != -1);
+        const uint64_t zero[3] = {0, 0, 0};    // _capacity, _b, _e, after the magic, the version, and the width
+        assert(::pwrite(fd, zero, sizeof(zero), 16) == sizeof(zero));
+        ::close(fd);
+        MyMappedDeque<int> y;
+        try {
+            y.open(path);
+            assert(false);}
+        catch (const std::runtime_error&) {
+            assert(!y.is_open());}}
+
+    // -----
+    // suite
+    // -----
+
+    CPPUNIT_TEST_SUITE(TestMappedDeque);
+    CPPUNIT_TEST(test_open);
+    CPPUNIT_TEST(test_reopen);
+    CPPUNIT_TEST(test_fifo);
+    CPPUNIT_TEST(test_width);
+    CPPUNIT_TEST(test_capacity);
+    CPPUNIT_TEST_SUITE_END();};
+
+// ---------------
+// TestDequeStream
+// ---------------
+
+struct TestDequeStream : CppUnit::TestFixture {
+    int fd;
+
+    void setUp () {
+        fd = ::open("TestDequeStream.dat", O_RDWR | O_CREAT | O_TRUNC, 0644);
+        assert(fd != -1);}
+
+    void tearDown () {
+        ::close(fd);
+        std::remove("TestDequeStream.dat");}
+
+    // -------------
+    // test_snapshot
+    // -------------
+
+    void test_snapshot () {
+        MyDeque<int> x;
+        for (int i = 0; i != 1000; ++i) {
+            x.push_back(i);
+            x.push_front(-i);}
+        write_to(fd, x);
+        ::lseek(fd, 0, SEEK_SET);
+        MyDeque<int> y(10, 7);
+        read_from(fd, y);
+        assert(x == y);}
+
+    // ----------
+    // test_empty
+    // ----------
+
+    void test_empty () {
+        const MyDeque<double> x;
+        write_to(fd, x);
+        ::lseek(fd, 0, SEEK_SET);
+        MyDeque<double> y(3, 1.5);
+        read_from(fd, y);
+        assert(y.empty());}
+
+    // -----------
+    // test_stream
+    // -----------
+
+    void test_stream () {
+        MyDequeStreamWriter<int> w(fd);
+        const MyDeque<int> x(100, 1);
+        const int a[] = {2, 3, 4};
+        w.append(x);
+        w.append(a, 3);
+        ::lseek(fd, 0, SEEK_SET);
+        MyDequeStreamReader<int> r(fd);
+        MyDeque<int> y;
+        assert(r.next(y) == 100);
+        assert(r.next(y) == 3);
+        assert(r.next(y) == 0);
+        assert(y.size() == 103);
+        assert(y.back() == 4);
+        ::lseek(fd, 0, SEEK_SET);
+        MyDeque<int> z;
+        read_from(fd, z);
+        assert(y == z);}
+
+    // ---------
+    // test_tail
+    // ---------
+
+    void test_tail () {
+        MyDequeStreamWriter<int> w(fd);
+        const int a[] = {1, 2, 3, 4};
+        w.append(a, 2);
+        const int g = ::open("TestDequeStream.dat", O_RDONLY);
+        assert(g != -1);
+        MyDequeStreamReader<int> r(g);
+        MyDeque<int> y;
+        assert(r.next(y) == 2);
+        const uint64_t c = 2;
+        assert(::write(fd, &c, 4) == 4);
+        assert(r.next(y) == 0);
+        assert(::write(fd, reinterpret_cast<const char*>(&c) + 4, 4) == 4);
+        assert(::write(fd, a + 2, sizeof(int)) == sizeof(int));
+        assert(r.next(y) == 0);
+        assert(y.size() == 2);
+        assert(::write(fd, a + 3, sizeof(int)) == sizeof(int));
+        assert(r.next(y) == 2);
+        assert(r.next(y) == 0);
+        assert((y.size() == 4) && (y.back() == 4));
+        ::close(g);}
+
+    // ----------
+    // test_count
+    // ----------
+
+    void test_count () {
+        MyDequeStreamWriter<int> w(fd);
+        const uint64_t c = uint64_t(1) << 60;
+        assert(::write(fd, &c, sizeof(c)) == sizeof(c));
+        ::lseek(fd, 0, SEEK_SET);
+        MyDeque<int> y;
+        try {
+            read_from(fd, y);
+            assert(false);}
+        catch (const std::runtime_error&) {}
+        ::lseek(fd, 0, SEEK_SET);
+        MyDequeStreamReader<int> r(fd);
+        assert(r.next(y) == 0);
+        assert(y.empty());}
+
+    // ----------
+    // test_width
+    // ----------
+
+    void test_width () {
+        write_to(fd, MyDeque<int>(5, 1));
+        ::lseek(fd, 0, SEEK_SET);
+        MyDeque<long long> y;
+        try {
+            read_from(fd, y);
+            assert(false);}
+        catch (const std::runtime_error&) {}}
+
+    // -----
+    // suite
+    // -----
+
+    CPPUNIT_TEST_SUITE(TestDequeStream);
+    CPPUNIT_TEST(test_snapshot);
+    CPPUNIT_TEST(test_empty);
+    CPPUNIT_TEST(test_stream);
+    CPPUNIT_TEST(test_tail);
+    CPPUNIT_TEST(test_count);
+    CPPUNIT_TEST(test_width);
+    CPPUNIT_TEST_SUITE_END();};
+
+// --------------
+// TestSpillDeque
+// --------------
+
+struct TestSpillDeque : CppUnit::TestFixture {
+
+    // ---------
+    // test_fifo
+    // ---------
+
+    void test_fifo () {
+        MySpillDeque<int> x(1024, ".", 64);
+        for (int i = 0; i != 100000; ++i)
+            x.push_back(i);
+        assert(x.resident() <= 16);
+        for (int i = 0; i != 100000; ++i) {
+            assert(x.front() == i);
+            x.pop_front();}
+        assert(x.empty());
+        assert(x.resident() == 0);}
+
+    // --------------
+    // test_both_ends
+    // --------------
+
+    void test_both_ends () {
+        MySpillDeque<int> x(256, ".", 64);
+        std::deque<int> y;
+        for (int i = 0; i != 20000; ++i) {
+            x.push_back(i);
+            y.push_back(i);
+            x.push_front(-i);
+            y.push_front(-i);}
+        for (int i = 0; i != 5000; ++i) {
+            x.pop_back();
+            y.pop_back();}
+        assert(x.size() == y.size());
+        assert(x.back() == y.back());
+        assert(x.front() == y.front());}
+
+    // --------------
+    // test_subscript
+    // --------------
+
+    void test_subscript () {
+        MySpillDeque<long> x(512, ".", 64);
+        for (long i = 0; i != 10000; ++i)
+            x.push_back(i);
+        x[5000] = -1;
+        for (long i = 0; i < 10000; i += 7)
+            assert(x.at(i) == i);
+        assert(x[5000] == -1);
+        assert(x.resident() <= 8 + 1);}
+
+    // ---------
+    // test_full
+    // ---------
+
+    /**
+     * Caps the file size at 0 so that every spill fails, and checks that
+     * a push that fails to spill leaves the deque as it was.
+     */
+    void test_full () {
+        MySpillDeque<int> x(256, ".", 64);
+        std::deque<int> y;
+        for (int i = 0; i != 1024; ++i) {
+            x.push_back(i);
+            y.push_back(i);}
+        struct rlimit r;
+        assert(::getrlimit(RLIMIT_FSIZE, &r) == 0);
+        struct rlimit z = r;
+        z.rlim_cur = 0;
+        void (*h)(int) = std::signal(SIGXFSZ, SIG_IGN);
+        assert(::setrlimit(RLIMIT_FSIZE, &z) == 0);
+        try {
+            x.push_front(-1);
+            assert(false);}
+        catch (std::system_error&) {}
+        try {
+            x.push_back(1024);
+            assert(false);}
+        catch (std::system_error&) {}
+        assert(::setrlimit(RLIMIT_FSIZE, &r) == 0);
+        std::signal(SIGXFSZ, h);
+        assert(x.size() == y.size());
+        assert((x.front() == 0) && (x.back() == 1023));
+        for (std::size_t i = 0; i != y.size(); ++i)
+            assert(x.at(i) == y[i]);
+        x.push_front(-1);
+        x.push_back(1024);
+        assert((x.front() == -1) && (x.back() == 1024) && (x.at(1) == 0));}
+
+    // -----
+    // suite
+    // -----
+
+    CPPUNIT_TEST_SUITE(TestSpillDeque);
+    CPPUNIT_TEST(test_fifo);
+    CPPUNIT_TEST(test_both_ends);
+    CPPUNIT_TEST(test_subscript);
+    CPPUNIT_TEST(test_full);
+    CPPUNIT_TEST_SUITE_END();};
+
+// ---------------------
+// TestHugePageAllocator
+// ---------------------
+
+struct TestHugePageAllocator : CppUnit::TestFixture {
+
+    // ----------
+    // test_small
+    // ----------
+
+    void test_small () {
+        MyHugePageAllocator<int> a;
+        int* p = a.allocate(10);
+        a.construct(p, 3);
+        assert(*p == 3);
+        a.destroy(p);
+        a.deallocate(p, 10);}
+
+    // ----------
+    // test_large
+    // ----------
+
+    void test_large () {
+        MyHugePageAllocator<long> a;
+        const std::size_t n = 3 * HUGE_PAGE / sizeof(long);
+        long* p = a.allocate(n);
+        assert(reinterpret_cast<uintptr_t>(p) % HUGE_PAGE == 0);
+        p[0] = 1;
+        p[n - 1] = 2;
+        assert(p[0] + p[n - 1] == 3);
+        a.deallocate(p, n);}
+
+    // ---------------
+    // test_no_options
+    // ---------------
+
+    void test_no_options () {
+        MyHugePageAllocator<char> a(0);
+        char* p = a.allocate(HUGE_PAGE);
+        p[HUGE_PAGE - 1] = 'x';
+        a.deallocate(p, HUGE_PAGE);}
+
+    // ----------
+    // test_deque
+    // ----------
+
+    void test_deque () {
+        MyDeque<long, MyHugePageAllocator<long> > x(HUGE_PAGE / sizeof(long), 1);
+        x.push_back(2);
+        x.push_front(0);
+        assert(x.front() == 0);
+        assert(x[1] == 1);
+        assert(x.back() == 2);}
+
+    // -----
+    // suite
+    // -----
+
+    CPPUNIT_TEST_SUITE(TestHugePageAllocator);
+    CPPUNIT_TEST(test_small);
+    CPPUNIT_TEST(test_large);
+    CPPUNIT_TEST(test_no_options);
+    CPPUNIT_TEST(test_deque);
+    CPPUNIT_TEST_SUITE_END();};
+
+// -----------------
+// TestSlidingWindow
+// -----------------
+
+struct TestSlidingWindow : CppUnit::TestFixture {
+
+    // ------
+    // concat
+    // ------
+
+    struct concat {
+        std::string operator () (const std::string& a, const std::string& b) const {
+            return a + b;}};
+
+    // --------------
+    // test_min_count
+    // --------------
+
+    void test_min_count () {
+        MyMonotonicWindow<int> x;
+        std::deque<int> y;
+        std::srand(1);
+        for (long i = 0; i != 2000; ++i) {
+            const int v = std::rand() % 100;
+            x.push(i, v);
+            y.push_back(v);
+            x.evict(i - 49);
+            if (y.size() > 50)
+                y.pop_front();
+            assert(x.top() == *std::min_element(y.begin(), y.end()));}}
+
+    // -------------
+    // test_max_time
+    // -------------
+
+    void test_max_time () {
+        MyMonotonicWindow<int, std::greater<int> > x;
+        std::deque< std::pair<long, int> > y;
+        std::srand(2);
+        long t = 0;
+        for (int i = 0; i != 2000; ++i) {
+            t += std::rand() % 10;
+            const int v = std::rand() % 1000;
+            x.push(t, v);
+            y.push_back(std::make_pair(t, v));
+            x.evict(t - 100);
+            while (y.front().first < t - 100)
+                y.pop_front();
+            int m = y.front().second;
+            for (std::size_t j = 1; j != y.size(); ++j)
+                m = std::max(m, y[j].second);
+            assert(x.top() == m);
+            assert(x.top_key() >= t - 100);}}
+
+    // ----------
+    // test_empty
+    // ----------
+
+    void test_empty () {
+        MyMonotonicWindow<int> x;
+        assert(x.empty());
+        x.push(0, 3);
+        x.push(0, 2);
+        assert(x.size() == 1);
+        x.evict(1);
+        assert(x.empty());
+        MyWindowAggregate<int, std::plus<int> > y;
+        assert(y.empty());
+        y.push(0, 1);
+        y.evict(1);
+        assert(y.empty());}
+
+    // --------
+    // test_sum
+    // --------
+
+    void test_sum () {
+        MyWindowAggregate<long, std::plus<long> > x;
+        std::deque<long> y;
+        std::srand(3);
+        for (long i = 0; i != 2000; ++i) {
+            const long v = std::rand() % 1000 - 500;
+            x.push(i, v);
+            y.push_back(v);
+            if (x.size() > 64)
+                x.pop();
+            if (y.size() > 64)
+                y.pop_front();
+            long s = 0;
+            for (std::size_t j = 0; j != y.size(); ++j)
+                s += y[j];
+            assert(x.get() == s);
+            assert(x.size() == y.size());}}
+
+    // ------------
+    // test_ordered
+    // ------------
+
+    void test_ordered () {
+        MyWindowAggregate<std::string, concat> x;
+        const char* s = "abcdefghij";
+        for (long i = 0; i != 10; ++i) {
+            x.push(i, std::string(1, s[i]));
+            x.evict(i - 3);
+            assert(x.get() == std::string(s + std::max(0L, i - 3), s + i + 1));}}
+
+    // -----
+    // suite
+    // -----
+
+    CPPUNIT_TEST_SUITE(TestSlidingWindow);
+    CPPUNIT_TEST(test_min_count);
+    CPPUNIT_TEST(test_max_time);
+    CPPUNIT_TEST(test_empty);
+    CPPUNIT_TEST(test_sum);
+    CPPUNIT_TEST(test_ordered);
+    CPPUNIT_TEST_SUITE_END();};
+
+// ------------
+// TestSoADeque
+// ------------
+
+struct TestSoADeque : CppUnit::TestFixture {
+    typedef MySoADeque<int, double, char> deque_type;
+
+    // -------
+    // Thrower
+    // -------
+
+    struct Thrower {
+        static bool fail;
+
+        Thrower () {}
+
+        Thrower (const Thrower&) {
+            if (fail)
+                throw std::runtime_error("Thrower");}};
+
+    // ---------
+    // test_push
+    // ---------
+
+    void test_push () {
+        deque_type x;
+        x.push_back(std::make_tuple(2, 2.5, 'b'));
+        x.push_front(std::make_tuple(1, 1.5, 'a'));
+        x.push_back(std::make_tuple(3, 3.5, 'c'));
+        assert(x.size() == 3);
+        assert(std::get<0>(x.front()) == 1);
+        assert(std::get<2>(x.back()) == 'c');
+        assert(x[1] == std::make_tuple(2, 2.5, 'b'));
+        x.pop_front();
+        x.pop_back();
+        assert(x.size() == 1);
+        assert(x.get<1>(0) == 2.5);}
+
+    // ----------
+    // test_proxy
+    // ----------
+
+    void test_proxy () {
+        deque_type x(3, std::make_tuple(0, 0.0, 'z'));
+        std::get<0>(x[1]) = 7;
+        x[2] = std::make_tuple(8, 8.5, 'y');
+        x.get<1>(0) = 0.5;
+        const deque_type& y = x;
+        assert(std::get<0>(y[1]) == 7);
+        assert(std::get<1>(y.at(2)) == 8.5);
+        assert(y.get<1>(0) == 0.5);
+        assert(std::get<2>(y[0]) == 'z');}
+
+    // -------
+    // test_at
+    // -------
+
+    void test_at () {
+        deque_type x(2);
+        try {
+            x.at(2);
+            assert(false);}
+        catch (std::out_of_range&) {}}
+
+    // -----------
+    // test_column
+    // -----------
+
+    void test_column () {
+        deque_type x;
+        assert(x.column<0>().empty());
+        for (int i = 0; i != 1000; ++i)
+            if (i % 2)
+                x.push_back(std::make_tuple(i, i / 2.0, 'a'));
+            else
+                x.push_front(std::make_tuple(i, i / 2.0, 'a'));
+        const MyColumn<int> c = x.column<0>();
+        assert(c.size() == 1000);
+        long s = 0;
+        for (const int* p = c.begin(); p != c.end(); ++p)
+            s += *p;
+        assert(s == 499500);
+        assert(c[0] == 998);
+        assert(c[999] == 999);
+        const deque_type& y = x;
+        assert(y.column<1>()[999] == 499.5);}
+
+    // ----------
+    // test_equal
+    // ----------
+
+    void test_equal () {
+        deque_type x(5);
+        deque_type y(x);
+        assert(x == y);
+        y.get<2>(4) = 'q';
+        assert(x != y);
+        x.swap(y);
+        assert(x.get<2>(4) == 'q');
+        x.resize(2);
+        assert(x.size() == 2);
+        x.clear();
+        assert(x.empty());}
+
+    // -------------
+    // test_rollback
+    // -------------
+
+    void test_rollback () {
+        MySoADeque<int, Thrower> x;
+        x.push_back(std::make_tuple(1, Thrower()));
+        const std::tuple<int, Thrower> v(2, Thrower());
+        Thrower::fail = true;
+        try {
+            x.push_back(v);
+            assert(false);}
+        catch (std::runtime_error&) {}
+        try {
+            x.push_front(v);
+            assert(false);}
+        catch (std::runtime_error&) {}
+        try {
+            x.resize(5, v);
+            assert(false);}
+        catch (std::runtime_error&) {}
+        Thrower::fail = false;
+        assert(x.size() == 1);
+        assert(x.column<0>().size() == 1);
+        assert(x.column<1>().size() == 1);
+        assert(x.get<0>(0) == 1);
+        x.resize(3, v);
+        assert((x.size() == 3) && (x.get<0>(2) == 2));}
+
+    // -----
+    // suite
+    // -----
+
+    CPPUNIT_TEST_SUITE(TestSoADeque);
+    CPPUNIT_TEST(test_push);
+    CPPUNIT_TEST(test_proxy);
+    CPPUNIT_TEST(test_at);
+    CPPUNIT_TEST(test_column);
+    CPPUNIT_TEST(test_equal);
+    CPPUNIT_TEST(test_rollback);
+    CPPUNIT_TEST_SUITE_END();};
+
+bool TestSoADeque::Thrower::fail = false;
+
+// -------------------
+// TestCompressedDeque
+// -------------------
+
+struct TestCompressedDeque : CppUnit::TestFixture {
+    typedef MyCompressedDeque<long long> deque_type;
+
+    // -------------
+    // test_monotone
+    // -------------
+
+    void test_monotone () {
+        deque_type x(16 << 10);
+        long long t = 1380000000000LL;
+        std::srand(4);
+        for (int i = 0; i != 100000; ++i)
+            x.push_back(t += std::rand() % 20);
+        const MyCompressionReport r = x.report();
+        assert(r._elements == 100000);
+        assert(r._hot <= 2);
+        assert(r.ratio() > 4);
+        std::srand(4);
+        t = 1380000000000LL;
+        const deque_type& y = x;
+        for (int i = 0; i != 100000; ++i)
+            assert(y[i] == (t += std::rand() % 20));
+        assert(x.report()._misses != 0);}
+
+    // ----------
+    // test_frame
+    // ----------
+
+    void test_frame () {
+        MyCompressedDeque<int> x(0, 1, 1 << 10);
+        std::srand(5);
+        std::deque<int> y;
+        for (int i = 0; i != 20000; ++i) {
+            const int v = 1000000 + std::rand() % 256;
+            x.push_front(v);
+            y.push_front(v);}
+        assert(x.report().ratio() > 3);
+        const MyCompressedDeque<int>& z = x;
+        for (std::size_t i = 0; i != y.size(); ++i)
+            assert(z.at(i) == y[i]);}
+
+    // ---------
+    // test_wide
+    // ---------
+
+    void test_wide () {
+        MyCompressedDeque<unsigned long long> x(0, 1, 64);
+        for (int i = 0; i != 100; ++i)
+            x.push_back((i % 2) ? ~0ULL - i : i);
+        x.compact();
+        assert(x.report()._cold == 11);
+        const MyCompressedDeque<unsigned long long>& y = x;
+        for (int i = 0; i != 100; ++i)
+            assert(y[i] == ((i % 2) ? ~0ULL - i : i));}
+
+    // ----------
+    // test_write
+    // ----------
+
+    void test_write () {
+        deque_type x(0, 1, 64);
+        for (int i = 0; i != 1000; ++i)
+            x.push_back(i);
+        x.compact();
+        const std::size_t cold = x.report()._cold;
+        x[500] = -1;
+        assert(x.report()._cold == cold - 1);
+        const deque_type& y = x;
+        assert(y[500] == -1);
+        assert(y[501] == 501);}
+
+    // --------
+    // test_pop
+    // --------
+
+    void test_pop () {
+        deque_type x(0, 1, 64);
+        for (int i = 0; i != 1000; ++i)
+            x.push_back(i);
+        x.compact();
+        for (int i = 0; i != 300; ++i) {
+            x.pop_front();
+            x.pop_back();}
+        assert(x.size() == 400);
+        assert(x.front() == 300);
+        assert(x.back() == 699);
+        x.push_front(-5);
+        assert(x.at(0) == -5);
+        x.clear();
+        assert(x.empty());
+        assert(x.report()._stored == 0);
+        try {
+            x.at(0);
+            assert(false);}
+        catch (std::out_of_range&) {}}
+
+    // ---------
+    // test_ends
+    // ---------
+
+    void test_ends () {
+        deque_type x(0, 1, 64);
+        for (int i = 0; i != 40; ++i)
+            x.push_back(i);
+        x.compact();
+        assert(x.report()._cold == 3);
+        for (int i = 0; i != 8; ++i)
+            x.pop_front();
+        assert(x.report()._hot == 2);
+        assert(x.report()._cold == 2);
+        for (int i = 0; i != 8; ++i)
+            x.pop_back();
+        assert(x.report()._hot == 2);
+        assert(x.report()._cold == 1);
+        x.push_front(-1);
+        x.push_back(-2);
+        assert(x.report()._hot == 2);
+        assert(x.report()._cold == 3);
+        assert((x.front() == -1) && (x.back() == -2));
+        assert((x[1] == 8) && (x[24] == 31));}
+
+    // -----
+    // suite
+    // -----
+
+    CPPUNIT_TEST_SUITE(TestCompressedDeque);
+    CPPUNIT_TEST(test_monotone);
+    CPPUNIT_TEST(test_frame);
+    CPPUNIT_TEST(test_wide);
+    CPPUNIT_TEST(test_write);
+    CPPUNIT_TEST(test_pop);
+    CPPUNIT_TEST(test_ends);
+    CPPUNIT_TEST_SUITE_END();};
+
+// ---------------
+// TestDequeBlocks
+// ---------------
+
+struct TestDequeBlocks : CppUnit::TestFixture {
+
+    // -----
+    // Block
+    // -----
+
+    struct Block {
+        int* _data;
+
+        Block ()
+            : _data(0) {}};
+
+    // -----
+    // Owner
+    // -----
+
+    /**
+     * A BlockRing owner of blocks of 4 ints whose open and opened throw
+     * when asked to; opened throws after recording the block, as an
+     * eviction that fails does.
+     */
+    struct Owner {
+        BlockRing<Block>    _ring;
+        std::set<long long> _ids;
+        bool                _open;
+        bool                _opened;
+
+        Owner ()
+            : _ring(4), _ids(), _open(false), _opened(false) {}
+
+        ~Owner () {
+            _ring.clear(*this);}
+
+        void open (Block* b) {
+            if (_open)
+                throw std::runtime_error("open");
+            b->_data = new int[4];}
+
+        void opened (long long id) {
+            _ids.insert(id);
+            if (_opened)
+                throw std::runtime_error("opened");}
+
+        void drop (std::size_t k) {
+            delete [] _ring._blocks[k]->_data;
+            _ids.erase(_ring._first + k);}
+
+        void ended (std::size_t) {}
+
+        int* write (std::size_t k) {
+            return _ring._blocks[k]->_data;}};
+
+    // ---------
+    // unchanged
+    // ---------
+
+    static void unchanged (const Owner& x) {
+        assert(x._ring.valid());
+        assert((x._ring._first == 0) && (x._ring._head == 0) && (x._ring._size == 4));
+        assert(x._ring._blocks.size() == 1);
+        assert((x._ids.size() == 1) && (*x._ids.begin() == 0));
+        for (int i = 0; i != 4; ++i)
+            assert(x._ring._blocks[0]->_data[i] == i);}
+
+    // --------
+    // test_add
+    // --------
+
+    void test_add () {
+        Owner x;
+        for (int i = 0; i != 4; ++i)
+            x._ring.push_back(x, i);
+        x._opened = true;
+        try {
+            x._ring.push_front(x, -1);
+            assert(false);}
+        catch (std::runtime_error&) {}
+        unchanged(x);
+        try {
+            x._ring.push_back(x, 4);
+            assert(false);}
+        catch (std::runtime_error&) {}
+        unchanged(x);
+        x._opened = false;
+        x._open   = true;
+        try {
+            x._ring.push_front(x, -1);
+            assert(false);}
+        catch (std::runtime_error&) {}
+        unchanged(x);
+        x._open = false;
+        x._ring.push_front(x, -1);
+        x._ring.push_back(x, 4);
+        assert(x._ring.valid());
+        assert((x._ring._first == -1) && (x._ring._head == 3) && (x._ring._size == 6));
+        assert((x._ring._blocks[0]->_data[3] == -1) && (x._ring._blocks[2]->_data[0] == 4));
+        assert(x._ids.size() == 3);}
+
+    // -----
+    // suite
+    // -----
+
+    CPPUNIT_TEST_SUITE(TestDequeBlocks);
+    CPPUNIT_TEST(test_add);
+    CPPUNIT_TEST_SUITE_END();};
+
+// -------------
+// TestDequeSort
+// -------------
+
+struct TestDequeSort : CppUnit::TestFixture {
+
+    // --------
+    // by_first
+    // --------
+
+    struct by_first {
+        bool operator () (const std::pair<int, int>& x, const std::pair<int, int>& y) const {
+            return x.first < y.first;}};
+
+    // ----------
+    // test_radix
+    // ----------
+
+    void test_radix () {
+        MyDeque<int> x;
+        std::deque<int> y;
+        std::srand(6);
+        for (int i = 0; i != 200000; ++i) {
+            const int v = std::rand() - RAND_MAX / 2;
+            x.push_back(v);
+            y.push_back(v);}
+        x.sort();
+        std::sort(y.begin(), y.end());
+        assert(std::equal(x.begin(), x.end(), y.begin()));}
+
+    // ------------
+    // test_strings
+    // ------------
+
+    void test_strings () {
+        MyDeque<std::string> x;
+        for (int i = 0; i != 1000; ++i)
+            x.push_front(std::string(1, static_cast<char>('a' + (i * 7) % 26)) + "x");
+        x.sort();
+        assert(std::is_sorted(x.begin(), x.end()));
+        x.sort(std::greater<std::string>());
+        assert(x.front() == "zx");
+        assert(x.back() == "ax");}
+
+    // -----------
+    // test_stable
+    // -----------
+
+    void test_stable () {
+        MyDeque< std::pair<int, int> > x;
+        std::deque< std::pair<int, int> > y;
+        for (int i = 0; i != 100000; ++i) {
+            x.push_back(std::make_pair(i % 100, i));
+            y.push_back(std::make_pair(i % 100, i));}
+        x.stable_sort(by_first());
+        std::stable_sort(y.begin(), y.end(), by_first());
+        assert(std::equal(x.begin(), x.end(), y.begin()));}
+
+    // -------------
+    // test_parallel
+    // -------------
+
+    void test_parallel () {
+        MyDeque<long> x;
+        MyDeque< std::pair<int, int> > y;
+        std::deque< std::pair<int, int> > z;
+        std::srand(7);
+        for (int i = 0; i != 300000; ++i) {
+            x.push_back(std::rand() % 1000);
+            y.push_back(std::make_pair(std::rand() % 1000, i));
+            z.push_back(y.back());}
+        x.sort(std::less<long>(), 4);
+        assert(std::is_sorted(x.begin(), x.end()));
+        assert(x.size() == 300000);
+        y.stable_sort(by_first(), 3);
+        std::stable_sort(z.begin(), z.end(), by_first());
+        assert(std::equal(y.begin(), y.end(), z.begin()));}
+
+    // ----------
+    // test_merge
+    // ----------
+
+    void test_merge () {
+        MyDeque< std::pair<int, int> > x;
+        MyDeque< std::pair<int, int> > y;
+        for (int i = 0; i != 10; ++i) {
+            x.push_back(std::make_pair(2 * i, 0));
+            y.push_back(std::make_pair(i, 1));}
+        x.merge(std::move(y), by_first());
+        assert(y.empty());
+        assert(x.size() == 20);
+        assert(std::is_sorted(x.begin(), x.end(), by_first()));
+        assert(x[0] == std::make_pair(0, 0));
+        assert(x[1] == std::make_pair(0, 1));
+        MyDeque<int> a;
+        MyDeque<int> b(3, 1);
+        a.merge(std::move(b));
+        assert(a.size() == 3);
+        a.merge(MyDeque<int>());
+        assert(a.size() == 3);}
+
+    // -----
+    // suite
+    // -----
+
+    CPPUNIT_TEST_SUITE(TestDequeSort);
+    CPPUNIT_TEST(test_radix);
+    CPPUNIT_TEST(test_strings);
+    CPPUNIT_TEST(test_stable);
+    CPPUNIT_TEST(test_parallel);
+    CPPUNIT_TEST(test_merge);
+    CPPUNIT_TEST_SUITE_END();};
+
+// ------
+// Counts
+// ------
+
+/**
+ * Counters bumped by CountingAllocator and Counted, atomic so that
+ * elements can be built on several threads; each test resets them.
+ * live and blocks, the elements and the allocations not yet freed, are
+ * not reset, so they can be checked for leaks at the end. A copy that
+ * takes fuse to zero throws, and so does an allocation that takes fail
+ * to zero.
+ */
+struct Counts {
+    static std::atomic<long> allocations;
+    static std::atomic<long> deallocations;
+    static std::atomic<long> defaults;
+    static std::atomic<long> copies;
+    static std::atomic<long> live;
+    static std::atomic<long> blocks;
+    static std::atomic<long> fuse;
+    static std::atomic<long> fail;
+
+    static void reset () {
+        allocations = deallocations = defaults = copies = fuse = fail = 0;}};
+
+std::atomic<long> Counts::allocations(0);
+std::atomic<long> Counts::deallocations(0);
+std::atomic<long> Counts::defaults(0);
+std::atomic<long> Counts::copies(0);
+std::atomic<long> Counts::live(0);
+std::atomic<long> Counts::blocks(0);
+std::atomic<long> Counts::fuse(0);
+std::atomic<long> Counts::fail(0);
+
+// -----------------
+// CountingAllocator
+// -----------------
+
+/**
+ * std::allocator, counting calls to allocate and deallocate.
+ */
+template <typename T>
+struct CountingAllocator {
+    typedef T              value_type;
+
+    typedef std::size_t    size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    typedef T*             pointer;
+    typedef const T*       const_pointer;
+
+    typedef T&             reference;
+    typedef const T&       const_reference;
+
+    template <typename U>
+    struct rebind {
+        typedef CountingAllocator<U> other;};
+
+    CountingAllocator () {}
+
+    template <typename U>
+    CountingAllocator (const CountingAllocator<U>&) {}
+
+    friend bool operator == (const CountingAllocator&, const CountingAllocator&) {
+        return true;}
+
+    friend bool operator != (const CountingAllocator&, const CountingAllocator&) {
+        return false;}
+
+    pointer allocate (size_type n) {
+        if (Counts::fail && (--Counts::fail == 0))
+            throw std::bad_alloc();
+        ++Counts::allocations;
+        ++Counts::blocks;
+        return std::allocator<T>().allocate(n);}
+
+    void deallocate (pointer p, size_type n) {
+        ++Counts::deallocations;
+        --Counts::blocks;
+        std::allocator<T>().deallocate(p, n);}};
+
+// -------
+// Counted
+// -------
+
+/**
+ * An int that counts its default constructions, its copies, constructed
+ * and assigned, and how many of it are alive.
+ */
+struct Counted {
+    int _v;
+
+    Counted ()
+        : _v(0) {
+        ++Counts::defaults;
+        ++Counts::live;}
+
+    Counted (int v)
+        : _v(v) {
+        ++Counts::live;}
+
+    Counted (const Counted& that)
+        : _v(that._v) {
+        if (Counts::fuse && (--Counts::fuse == 0))
+            throw std::runtime_error("Counted");
+        ++Counts::copies;
+        ++Counts::live;}
+
+    ~Counted () {
+        --Counts::live;}
+
+    Counted& operator = (const Counted& that) {
+        ++Counts::copies;
+        _v = that._v;
+        return *this;}
+
+    friend bool operator == (const Counted& lhs, const Counted& rhs) {
+        return lhs._v == rhs._v;}
+
+    friend bool operator < (const Counted& lhs, const Counted& rhs) {
+        return lhs._v < rhs._v;}};
+
+// ---------------
+// TestDequeBounds
+// ---------------
+
+struct TestDequeBounds : CppUnit::TestFixture {
+    typedef MyDeque< Counted, CountingAllocator<Counted> > D;
+
+    // ---
+    // lg2
+    // ---
+
+    static long lg2 (long n) {
+        long k = 0;
+        while (n >>= 1)
+            ++k;
+        return k;}
+
+    // -----
+    // setUp
+    // -----
+
+    void setUp () {
+        Counts::reset();
+        Counts::live   = 0;
+        Counts::blocks = 0;}
+
+    // --------
+    // tearDown
+    // --------
+
+    void tearDown () {
+        assert(Counts::live == 0);
+        assert(Counts::blocks == 0);}
+
+    // ---------------
+    // test_push_back
+    // ---------------
+
+    void test_push_back () {
+        const long n = 100000;
+        D x;
+        for (long i = 0; i != n; ++i)
+            x.push_back(Counted(i));
+        assert(Counts::allocations <= lg2(n) + 4);
+        assert(Counts::copies <= 5 * n);
+        assert(Counts::defaults == 0);}
+
+    // ---------------
+    // test_push_front
+    // ---------------
+
+    void test_push_front () {
+        const long n = 100000;
+        D x;
+        for (long i = 0; i != n; ++i)
+            x.push_front(Counted(i));
+        assert(Counts::allocations <= lg2(n) + 4);
+        assert(Counts::copies <= 5 * n);
+        assert(Counts::defaults == 0);
+        assert(x.front() == Counted(n - 1));}
+
+    // -----------
+    // test_resize
+    // -----------
+
+    void test_resize () {
+        const long n = 1000;
+        D x;
+        x.resize(n);
+        assert(Counts::allocations == 1);
+        assert(Counts::defaults == 1);
+        assert(Counts::copies <= n + 1);
+        Counts::reset();
+        x.resize(3 * n, Counted(2));
+        assert(Counts::allocations == 1);
+        assert(Counts::defaults == 0);
+        assert(Counts::copies <= n + 2 * n + 1);
+        Counts::reset();
+        x.resize(n);
+        assert(Counts::allocations == 0);
+        assert(Counts::copies == 0);
+        assert(Counts::live == n);}
+
+    // ---------
+    // test_fifo
+    // ---------
+
+    void test_fifo () {
+        const long n = 1000;
+        const long m = 100000;
+        D x;
+        D y;
+        for (long i = 0; i != 10 * n; ++i) {
+            x.push_back(Counted(i));
+            y.push_front(Counted(i));
+            if (i >= n) {
+                x.pop_front();
+                y.pop_back();}}
+        Counts::reset();
+        for (long i = 0; i != m; ++i) {
+            x.push_back(Counted(i));
+            x.pop_front();
+            y.push_front(Counted(i));
+            y.pop_back();}
+        assert(Counts::allocations == 0);
+        assert(Counts::copies <= 2 * 3 * m);
+        assert(x.size() == static_cast<std::size_t>(n));
+        assert(x.back() == Counted(m - 1));
+        assert(y.front() == Counted(m - 1));}
+
+    // -------------
+    // test_both_ends
+    // -------------
+
+    void test_both_ends () {
+        const long m = 200000;
+        D x;
+        long pushes = 0;
+        std::srand(8);
+        for (long i = 0; i != m; ++i) {
+            const int r = std::rand() % 6;
+            if ((r < 2) && !x.empty())
+                (r ? x.pop_back() : x.pop_front());
+            else {
+                ((r % 2) ? x.push_back(Counted(r)) : x.push_front(Counted(r)));
+                ++pushes;}}
+        assert(Counts::allocations <= lg2(m) + 4);
+        assert(Counts::copies <= 5 * pushes);}
+
+    // ---------
+    // test_pops
+    // ---------
+
+    void test_pops () {
+        D x;
+        for (int i = 0; i != 1000; ++i)
+            x.push_back(Counted(i));
+        Counts::reset();
+        while (!x.empty()) {
+            x.pop_back();
+            if (!x.empty())
+                x.pop_front();}
+        assert(Counts::allocations == 0);
+        assert(Counts::copies == 0);
+        assert(Counts::live == 0);}
+
+    // ---------
+    // test_copy
+    // ---------
+
+    void test_copy () {
+        const D x;
+        const D y(x);
+        assert(y.empty());
+        assert(Counts::allocations == 0);
+        D z;
+        for (int i = 0; i != 100; ++i)
+            z.push_back(Counted(i));
+        Counts::reset();
+        const D w(z);
+        assert(w == z);
+        assert(Counts::allocations == 1);
+        assert(Counts::copies == 100);}
+
+    // --------------
+    // test_construct
+    // --------------
+
+    void test_construct () {
+        const D x(1000, Counted(1));
+        assert(Counts::allocations == 1);
+        assert(Counts::copies == 1000);
+        const std::deque<Counted> v(x.begin(), x.end());
+        Counts::reset();
+        const D y(v.begin(), v.end());
+        assert(y == x);
+        assert(Counts::allocations == 1);
+        assert(Counts::copies == 1000);
+        Counts::reset();
+        const D z = {Counted(1), Counted(2), Counted(3)};
+        assert(Counts::allocations == 1);
+        assert((z.size() == 3) && (z.back() == Counted(3)));
+        const D w(v.begin(), v.begin());
+        assert(w.empty());
+        std::istringstream in("4 5 6");
+        const MyDeque<int> u((std::istream_iterator<int>(in)), std::istream_iterator<int>());
+        assert((u.size() == 3) && (u.front() == 4) && (u.back() == 6));}
+
+    // -----------
+    // test_assign
+    // -----------
+
+    void test_assign () {
+        D x(1000, Counted(1));
+        Counts::reset();
+        x.assign(500, Counted(2));
+        assert(Counts::allocations == 0);
+        assert(Counts::live == 500);
+        x.assign(10, x[3]);
+        assert((x.size() == 10) && (x.back() == Counted(2)));
+        const D y(2000, Counted(3));
+        Counts::reset();
+        x.assign(y.begin(), y.end());
+        assert(x == y);
+        assert(Counts::allocations == 1);
+        assert(Counts::copies == 2000);
+        x.assign({Counted(4)});
+        assert((x.size() == 1) && (x.front() == Counted(4)));
+        x.assign(0, Counted(5));
+        assert(x.empty());}
+
+    // -------------
+    // test_parallel
+    // -------------
+
+    void test_parallel () {
+        const long n = 4 * FILL_RUN + 3;
+        D x;
+        x.assign(n, Counted(7), 4);
+        assert(Counts::allocations == 1);
+        assert(Counts::live == n);
+        assert(std::count(x.begin(), x.end(), Counted(7)) == n);
+        D y;
+        y.assign(x.begin(), x.end(), 3);
+        assert(y == x);
+        Counts::reset();
+        Counts::fuse = 3 * FILL_RUN;
+        try {
+            y.assign(2 * n, Counted(8), 4);
+            assert(false);}
+        catch (std::runtime_error&) {}
+        assert(y == x);
+        assert(Counts::live == 2 * n);}
+
+    // ---------
+    // Countdown
+    // ---------
+
+    /**
+     * <, throwing once it has been called fuse times.
+     */
+    struct Countdown {
+        bool operator () (const Counted& x, const Counted& y) const {
+            if (Counts::fuse && (--Counts::fuse == 0))
+                throw std::runtime_error("Countdown");
+            return x < y;}};
+
+    // ---------
+    // test_sort
+    // ---------
+
+    void test_sort () {
+        const long n = 4 * SORT_RUN + 5;
+        D x;
+        for (long i = 0; i != n; ++i)
+            x.push_back(Counted((i * 7919) % n));
+        Counts::reset();
+        x.sort();
+        assert(Counts::allocations == 0);
+        assert(std::is_sorted(x.begin(), x.end()));
+        std::reverse(x.begin(), x.end());
+        x.sort(std::less<Counted>(), 4);
+        assert(Counts::allocations == 1);
+        assert(std::is_sorted(x.begin(), x.end()));
+        std::reverse(x.begin(), x.end());
+        Counts::reset();
+        Counts::fuse = 3 * SORT_RUN;
+        try {
+            x.sort(Countdown(), 4);
+            assert(false);}
+        catch (std::runtime_error&) {}
+        assert(x.size() == static_cast<std::size_t>(n));
+        assert(Counts::live == n);
+        x.sort();
+        for (long i = 0; i != n; ++i)
+            assert(x[i] == Counted(i));}
+
+    // -----
+    // suite
+    // -----
+
+    CPPUNIT_TEST_SUITE(TestDequeBounds);
+    CPPUNIT_TEST(test_push_back);
+    CPPUNIT_TEST(test_push_front);
+    CPPUNIT_TEST(test_resize);
+    CPPUNIT_TEST(test_fifo);
+    CPPUNIT_TEST(test_both_ends);
+    CPPUNIT_TEST(test_pops);
+    CPPUNIT_TEST(test_copy);
+    CPPUNIT_TEST(test_construct);
+    CPPUNIT_TEST(test_assign);
+    CPPUNIT_TEST(test_parallel);
+    CPPUNIT_TEST(test_sort);
+    CPPUNIT_TEST_SUITE_END();};
+
+// ---------------
+// TestDequeStress
+// ---------------
+
+/**
+ * Applies the same random operations to a C and to a std::deque,
+ * and checks that they agree after every one.
+ */
+template <typename C>
+struct TestDequeStress : CppUnit::TestFixture {
+    typedef typename C::value_type T;
+
+    // ------
+    // stress
+    // ------
+
+    void stress (unsigned seed, int ops) {
+        C x;
+        std::deque<T> y;
+        std::srand(seed);
+        for (int i = 0; i != ops; ++i) {
+            const int r = std::rand() % 100;
+            const int v = std::rand() % 1000;
+            const std::size_t s = y.size();
+            const std::size_t k = s ? std::rand() % s : 0;
+            if (r < 20) {
+                x.push_back(T(v));
+                y.push_back(T(v));}
+            else if (r < 40) {
+                x.push_front(T(v));
+                y.push_front(T(v));}
+            else if ((r < 52) && s) {
+                x.pop_back();
+                y.pop_back();}
+            else if ((r < 64) && s) {
+                x.pop_front();
+                y.pop_front();}
+            else if (r < 72) {
+                x.insert(x.begin() + k, T(v));
+                y.insert(y.begin() + k, T(v));}
+            else if ((r < 80) && s) {
+                x.erase(x.begin() + k);
+                y.erase(y.begin() + k);}
+            else if ((r < 88) && s) {
+                x[k] = T(v);
+                y[k] = T(v);}
+            else if (r < 93) {
+                const std::size_t t = std::rand() % (2 * s + 2);
+                x.resize(t, T(v));
+                y.resize(t, T(v));}
+            else if (r < 96) {
+                const C z(x);
+                x = C();
+                x = z;}
+            else if (r < 99) {
+                C z(x);
+                x.swap(z);}
+            else {
+                x.clear();
+                y.clear();}
+            assert(x.size() == y.size());
+            assert(std::equal(x.begin(), x.end(), y.begin()));
+            if (!y.empty())
+                assert((x.front() == y.front()) && (x.back() == y.back()));}}
+
+    // -----------
+    // test_stress
+    // -----------
+
+    void test_stress () {
+        stress(1, 20000);
+        stress(2, 20000);}
+
+    // ----------
+    // test_small
+    // ----------
+
+    void test_small () {
+        for (unsigned seed = 3; seed != 103; ++seed)
+            stress(seed, 200);}
+
+    // -----
+    // suite
+    // -----
+
+    CPPUNIT_TEST_SUITE(TestDequeStress);
+    CPPUNIT_TEST(test_stress);
+    CPPUNIT_TEST(test_small);
+    CPPUNIT_TEST_SUITE_END();};
+
+// ----------------
+// TestIndexedDeque
+// ----------------
+
+struct TestIndexedDeque : CppUnit::TestFixture {
+    typedef MyIndexedDeque< Counted, CountingAllocator<Counted> > D;
+
+    // -----
+    // setUp
+    // -----
+
+    void setUp () {
+        Counts::reset();
+        Counts::live   = 0;
+        Counts::blocks = 0;}
+
+    // --------
+    // tearDown
+    // --------
+
+    void tearDown () {
+        assert(Counts::live == 0);
+        assert(Counts::blocks == 0);}
+
+    // ----------
+    // test_alias
+    // ----------
+
+    void test_alias () {
+        MyIndexedDeque<std::string> x;
+        std::deque<std::string> y;
+        for (int i = 0; i != 500; ++i) {
+            const std::string v(20, static_cast<char>('a' + i % 26));
+            x.push_back(v);
+            y.push_back(v);}
+        for (int i = 0; i != 200; ++i) {
+            x.push_front(x.front());
+            y.push_front(y.front());
+            x.push_back(x.back());
+            y.push_back(y.back());
+            x.insert(x.begin() + 3 * i, x[7 * i % x.size()]);
+            y.insert(y.begin() + 3 * i, y[7 * i % y.size()]);}
+        assert(x.size() == y.size());
+        assert(std::equal(x.begin(), x.end(), y.begin()));}
+
+    // ---------
+    // test_ends
+    // ---------
+
+    void test_ends () {
+        const long n = 100000;
+        D x;
+        for (long i = 0; i != n; ++i)
+            x.push_back(Counted(i));
+        assert(Counts::allocations <= 3 * n / COLUMNS);
+        assert(Counts::copies <= 2 * n);
+        Counts::reset();
+        D y;
+        for (long i = 0; i != n; ++i)
+            y.push_front(Counted(i));
+        assert(Counts::allocations <= 3 * n / COLUMNS);
+        assert(Counts::copies <= 3 * n);
+        Counts::reset();
+        for (long i = 0; i != n; ++i) {
+            x.push_back(Counted(i));
+            x.pop_front();
+            y.pop_back();
+            y.push_front(Counted(i));}
+        assert(Counts::copies <= 8 * n);
+        assert((x.front() == Counted(0)) && (x.back() == Counted(n - 1)));
+        assert((y.front() == Counted(n - 1)) && (y.back() == Counted(0)));}
+
+    // ----------
+    // test_index
+    // ----------
+
+    void test_index () {
+        MyIndexedDeque<int> x;
+        std::deque<int> y;
+        for (int i = 0; i != 3 * COLUMNS * FANOUT; ++i) {
+            x.push_back(i);
+            y.push_back(i);}
+        x.insert(x.begin() + 5, -1);
+        y.insert(y.begin() + 5, -1);
+        for (int i = 0; i != 2 * COLUMNS * FANOUT; ++i) {
+            x.push_back(i);
+            y.push_back(i);
+            x.push_front(-i);
+            y.push_front(-i);}
+        for (int i = 0; i != COLUMNS + 1; ++i) {
+            x.pop_back();
+            y.pop_back();
+            x.pop_front();
+            y.pop_front();}
+        assert(x.size() == y.size());
+        for (std::size_t i = 0; i != y.size(); ++i)
+            assert(x[i] == y[i]);
+        assert(x.at(y.size() - 1) == y.back());}
+
+    // --------------
+    // test_no_memory
+    // --------------
+
+    void test_no_memory () {
+        D x;
+        for (int i = 0; i != COLUMNS * FANOUT; ++i)
+            x.push_back(Counted(i));
+        const std::deque<Counted> y(x.begin(), x.end());
+        long fail = 1;
+        for (; ; ++fail) {
+            Counts::fail = fail;
+            try {
+                x.insert(x.begin() + 100, Counted(-1));
+                break;}
+            catch (std::bad_alloc&) {}
+            assert(x.size() == y.size());
+            assert(std::equal(x.begin(), x.end(), y.begin()));}
+        Counts::fail = 0;
+        assert(fail > 3);
+        assert(x[100] == Counted(-1));
+        assert(x.back() == y.back());}
+
+    // -----
+    // suite
+    // -----
+
+    CPPUNIT_TEST_SUITE(TestIndexedDeque);
+    CPPUNIT_TEST(test_alias);
+    CPPUNIT_TEST(test_ends);
+    CPPUNIT_TEST(test_index);
+    CPPUNIT_TEST(test_no_memory);
     CPPUNIT_TEST_SUITE_END();};
 
 // ----
@@ -432,6 +2179,22 @@ int main () {
     tr.addTest(TestDeque< std::deque<int, std::allocator<int> > >::suite());
     tr.addTest(TestDeque< MyDeque<int> >::suite());
     tr.addTest(TestDeque< MyDeque<int, std::allocator<int> > >::suite());
+    tr.addTest(TestDeque< MyDeque<int, MyHugePageAllocator<int> > >::suite());
+    tr.addTest(TestDeque< MyIndexedDeque<int> >::suite());
+    tr.addTest(TestMappedDeque::suite());
+    tr.addTest(TestDequeStream::suite());
+    tr.addTest(TestSpillDeque::suite());
+    tr.addTest(TestHugePageAllocator::suite());
+    tr.addTest(TestSlidingWindow::suite());
+    tr.addTest(TestSoADeque::suite());
+    tr.addTest(TestCompressedDeque::suite());
+    tr.addTest(TestDequeBlocks::suite());
+    tr.addTest(TestDequeSort::suite());
+    tr.addTest(TestDequeBounds::suite());
+    tr.addTest(TestDequeStress< MyDeque<int> >::suite());
+    tr.addTest(TestDequeStress< MyDeque< Counted, CountingAllocator<Counted> > >::suite());
+    tr.addTest(TestDequeStress< MyIndexedDeque<int> >::suite());
+    tr.addTest(TestIndexedDeque::suite());
     tr.run();
 
     cout << "Done." << endl;